@@ -231,6 +231,14 @@ extern "C" {
     jint Java_com_quantcast_qfs_access_KfsInputChannel_read(
         JNIEnv *jenv, jclass jcls, jlong jptr, jint jfd, jobject buf, jint begin, jint end);
 
+    jint Java_com_quantcast_qfs_access_KfsInputChannel_pread(
+        JNIEnv *jenv, jclass jcls, jlong jptr, jint jfd, jlong jpos,
+        jobject buf, jint begin, jint end);
+
+    jlong Java_com_quantcast_qfs_access_KfsInputChannel_preadv(
+        JNIEnv *jenv, jclass jcls, jlong jptr, jint jfd, jlongArray jpos,
+        jobjectArray bufs, jintArray begins, jintArray ends, jintArray sizes);
+
     jint Java_com_quantcast_qfs_access_KfsInputChannel_close(
         JNIEnv *jenv, jclass jcls, jlong jptr, jint jfd);
 
@@ -1550,6 +1558,105 @@ jint Java_com_quantcast_qfs_access_KfsInputChannel_read(
     return (jint)sz;
 }
 
+jint Java_com_quantcast_qfs_access_KfsInputChannel_pread(
+    JNIEnv *jenv, jclass jcls, jlong jptr, jint jfd, jlong jpos,
+    jobject buf, jint begin, jint end)
+{
+    if (! jptr) {
+        return -EFAULT;
+    }
+    KfsClient* const clnt = (KfsClient*)jptr;
+
+    if (! buf || jpos < 0) {
+        return -EINVAL;
+    }
+    void * addr = jenv->GetDirectBufferAddress(buf);
+    jlong cap = jenv->GetDirectBufferCapacity(buf);
+
+    if (! addr || cap < 0) {
+        return -EINVAL;
+    }
+    if(begin < 0 || end > cap || begin > end) {
+        return -EINVAL;
+    }
+    addr = (void *)(uintptr_t(addr) + begin);
+
+    ssize_t sz = clnt->PRead((int) jfd, (chunkOff_t) jpos,
+        (char *) addr, (size_t) (end - begin));
+    return (jint)sz;
+}
+
+/*
+ * Read multiple ranges with a single call. The number of bytes read into
+ * each buffer is returned in sizes. Reading stops at the first short read or
+ * error. Returns the total number of bytes read, or the error if nothing was
+ * read.
+ */
+jlong Java_com_quantcast_qfs_access_KfsInputChannel_preadv(
+    JNIEnv *jenv, jclass jcls, jlong jptr, jint jfd, jlongArray jpos,
+    jobjectArray bufs, jintArray begins, jintArray ends, jintArray sizes)
+{
+    if (! jptr) {
+        return -EFAULT;
+    }
+    KfsClient* const clnt = (KfsClient*)jptr;
+
+    if (! jpos || ! bufs || ! begins || ! ends || ! sizes) {
+        return -EINVAL;
+    }
+    const jsize cnt = jenv->GetArrayLength(bufs);
+    if (jenv->GetArrayLength(jpos) != cnt ||
+            jenv->GetArrayLength(begins) != cnt ||
+            jenv->GetArrayLength(ends) != cnt ||
+            jenv->GetArrayLength(sizes) != cnt) {
+        return -EINVAL;
+    }
+    if (cnt <= 0) {
+        return 0;
+    }
+    vector<jlong> pos(cnt);
+    vector<jint>  bg(cnt);
+    vector<jint>  en(cnt);
+    vector<jint>  res(cnt, 0);
+    vector<char*> addrs(cnt);
+    jenv->GetLongArrayRegion(jpos, 0, cnt, &pos[0]);
+    jenv->GetIntArrayRegion(begins, 0, cnt, &bg[0]);
+    jenv->GetIntArrayRegion(ends, 0, cnt, &en[0]);
+    for (jsize i = 0; i < cnt; i++) {
+        jobject const buf = jenv->GetObjectArrayElement(bufs, i);
+        if (! buf) {
+            return -EINVAL;
+        }
+        void * const addr = jenv->GetDirectBufferAddress(buf);
+        jlong  const cap  = jenv->GetDirectBufferCapacity(buf);
+        jenv->DeleteLocalRef(buf);
+        if (! addr || cap < 0 || pos[i] < 0 ||
+                bg[i] < 0 || en[i] > cap || bg[i] > en[i]) {
+            return -EINVAL;
+        }
+        addrs[i] = (char *)addr + bg[i];
+    }
+    jlong total = 0;
+    for (jsize i = 0; i < cnt; i++) {
+        const size_t  len = (size_t)(en[i] - bg[i]);
+        const ssize_t sz  = clnt->PRead((int) jfd, (chunkOff_t) pos[i],
+            addrs[i], len);
+        if (sz < 0) {
+            if (total <= 0) {
+                total = (jlong)sz;
+            }
+            break;
+        }
+        res[i] = (jint)sz;
+        total += sz;
+        if ((size_t)sz < len) {
+            break;
+        }
+    }
+    jenv->SetIntArrayRegion(sizes, 0, cnt, &res[0]);
+    return total;
+}
+
 jint Java_com_quantcast_qfs_access_KfsOutputChannel_write(
     JNIEnv *jenv, jclass jcls, jlong jptr, jint jfd, jobject buf, jint begin, jint end)
 {
@@ -1688,6 +1688,7 @@ AtomicRecordAppender::RunPendingSubmitQueue()
         }
     }
     mPendingSubmitQueue = 0;
+    int batchSize = 0;
     for (; ;) {
         if (mReplicationsInFlight <= 0 || mState == kStateNone) {
             FatalError("AtomicRecordAppender::RunPendingSubmitQueue:"
@@ -1743,6 +1744,7 @@ AtomicRecordAppender::RunPendingSubmitQueue()
             " status: "       << cur.status <<
             " " << cur.Show() <<
         KFS_LOG_EOM;
+        batchSize++;
         if (enqueueFlag) {
             mFirstFwdOpFlag = false;
             mPeer->Enqueue(&cur);
@@ -1753,6 +1755,18 @@ AtomicRecordAppender::RunPendingSubmitQueue()
             break;
         }
     }
+    // The appender might be deleted by the last op completion, counters are
+    // static.
+    typedef AtomicRecordAppendManager::Counters Counters;
+    Counters& counters = Cntrs();
+    counters.mAppendBatchCount++;
+    int idx = 0;
+    for (int n = batchSize;
+            4 <= n && idx < Counters::kAppendBatchHistogramSize - 1;
+            n /= 4) {
+        idx++;
+    }
+    counters.mAppendBatchSizeHistogram[idx]++;
 }
 
 int
@@ -46,6 +46,7 @@ public:
     struct Counters
     {
         typedef int64_t Counter;
+        enum { kAppendBatchHistogramSize = 5 };
 
         Counter mAppendCount;
         Counter mAppendByteCount;
@@ -79,6 +80,10 @@ public:
         Counter mLostChunkCount;
         Counter mPendingByteCount;
         Counter mLowOnBuffersFlushCount;
+        // Record appends submitted together by RunPendingSubmitQueue().
+        Counter mAppendBatchCount;
+        // Number of batches by ops per batch: [1, 4), [4, 16), [16, 64) etc.
+        Counter mAppendBatchSizeHistogram[kAppendBatchHistogramSize];
 
         void Clear()
         {
@@ -114,6 +119,10 @@ public:
             mLostChunkCount = 0;
             mPendingByteCount = 0;
             mLowOnBuffersFlushCount = 0;
+            mAppendBatchCount = 0;
+            for (int i = 0; i < kAppendBatchHistogramSize; i++) {
+                mAppendBatchSizeHistogram[i] = 0;
+            }
         }
     };
     AtomicRecordAppendManager();
@@ -67,6 +67,7 @@
 namespace KFS
 {
 using std::ofstream;
+using std::ifstream;
 using std::ostringstream;
 using std::istringstream;
 using std::min;
@@ -75,6 +76,7 @@ using std::string;
 using std::vector;
 using std::make_pair;
 using std::sort;
+using std::upper_bound;
 using std::unique;
 using std::greater;
 using std::set;
@@ -87,6 +89,8 @@ ChunkManager gChunkManager;
 
 typedef QCDLList<ChunkInfoHandle, 0> ChunkList;
 typedef QCDLList<ChunkInfoHandle, 1> ChunkDirList;
+typedef QCDLList<ChunkInfoHandle, ChunkManager::kChecksumsCacheListIdx>
+    ChecksumsCacheList;
 typedef ChunkList ChunkLru;
 
 // Chunk directory state. The present production deployment use one chunk
@@ -155,7 +159,19 @@ struct ChunkManager::ChunkDirInfo : public ITimeout
           availableChunksCb(),
           evacuateChunksOp(0, &evacuateChunksCb),
           availableChunksOp(0, &availableChunksCb),
-          chunkDirInfoOp(*this)
+          chunkDirInfoOp(*this),
+          inventoryChangeTime(-1),
+          scrubCb(),
+          scrubChunkId(-1),
+          nextScrubTime(0),
+          scrubChunkIds(),
+          scrubPos(0),
+          scrubByteBudget(0),
+          scrubBudgetTime(0),
+          scrubInFlightFlag(false),
+          scrubStartFlag(false),
+          scrubReleaseFlag(false),
+          scrubKeepChecksumsFlag(false)
     {
         fsSpaceAvailCb.SetHandler(this,
             &ChunkDirInfo::FsSpaceAvailDone);
@@ -169,6 +185,8 @@ struct ChunkManager::ChunkDirInfo : public ITimeout
             &ChunkDirInfo::RenameEvacuateFileDone);
         availableChunksCb.SetHandler(this,
             &ChunkDirInfo::AvailableChunksDone);
+        scrubCb.SetHandler(this,
+            &ChunkDirInfo::ScrubDone);
         for (int i = 0; i < kChunkDirListCount; i++) {
             ChunkList::Init(chunkLists[i]);
             ChunkDirList::Init(chunkLists[i]);
@@ -188,6 +206,7 @@ struct ChunkManager::ChunkDirInfo : public ITimeout
     void DiskError(int sysErr);
     int EvacuateChunksDone(int code, void* data);
     int AvailableChunksDone(int code, void* data);
+    int ScrubDone(int code, void* data);
     void ScheduleEvacuate(int maxChunkCount = -1);
     void RestartEvacuation();
     void NotifyAvailableChunks(bool tmeoutFlag = false);
@@ -698,6 +717,18 @@ struct ChunkManager::ChunkDirInfo : public ITimeout
     EvacuateChunksOp       evacuateChunksOp;
     AvailableChunksOp      availableChunksOp;
     ChunkDirInfoOp         chunkDirInfoOp;
+    int64_t                inventoryChangeTime; // Last inventory dir mtime.
+    KfsCallbackObj         scrubCb;
+    kfsChunkId_t           scrubChunkId; // Last scrubbed chunk.
+    time_t                 nextScrubTime;
+    vector<kfsChunkId_t>   scrubChunkIds; // Current pass chunk ids, sorted.
+    size_t                 scrubPos;
+    int64_t                scrubByteBudget;
+    int64_t                scrubBudgetTime;
+    bool                   scrubInFlightFlag;
+    bool                   scrubStartFlag;
+    bool                   scrubReleaseFlag;
+    bool                   scrubKeepChecksumsFlag;
 
     enum { kChunkInfoHDirListCount = kChunkInfoHandleListCount + 1 };
     enum ChunkListType
@@ -831,6 +862,9 @@ public:
           dataFH(),
           lastIOTime(0),
           readChunkMetaOp(0),
+          writeBlockCache(),
+          writeBlockCacheOffset(-1),
+          writeBlockCacheChecksum(0),
           mBeingReplicatedFlag(false),
           mDeleteFlag(false),
           mWriteAppenderOwnsFlag(false),
@@ -854,6 +888,7 @@ public:
     {
         ChunkList::Init(*this);
         ChunkDirList::Init(*this);
+        ChecksumsCacheList::Init(*this);
         ChunkDirList::PushBack(mChunkDir.chunkLists[mChunkDirList], *this);
         SET_HANDLER(this, &ChunkInfoHandle::HandleChunkMetaWriteDone);
         mChunkDir.chunkCount++;
@@ -914,8 +949,13 @@ public:
     time_t           lastIOTime;
     /// keep track of the op that is doing the read
     ReadChunkMetaOp* readChunkMetaOp;
+    /// Copy of the last partially written checksum block, and its position
+    /// and checksum, used to avoid read modify write by the next small write.
+    IOBuffer         writeBlockCache;
+    int64_t          writeBlockCacheOffset;
+    uint32_t         writeBlockCacheChecksum;
 
-    void Release(ChunkLists* chunkInfoLists);
+    void Release(ChunkLists* chunkInfoLists, bool keepChecksumsFlag = false);
     bool IsFileOpen() const {
         return (dataFH && dataFH->IsOpen());
     }
@@ -1165,6 +1205,8 @@ public:
         ChunkLists* chunkInfoLists);
 
 private:
+    enum { kListCount = ChunkManager::kChecksumsCacheListIdx + 1 };
+
     bool                        mBeingReplicatedFlag:1;
     bool                        mDeleteFlag:1;
     bool                        mWriteAppenderOwnsFlag:1;
@@ -1187,8 +1229,8 @@ private:
     KfsOp*                      mReadableNotifyHead;
     KfsOp*                      mReadableNotifyTail;
     ChunkDirInfo&               mChunkDir;
-    ChunkInfoHandle*            mPrevPtr[ChunkDirInfo::kChunkInfoHDirListCount];
-    ChunkInfoHandle*            mNextPtr[ChunkDirInfo::kChunkInfoHDirListCount];
+    ChunkInfoHandle*            mPrevPtr[kListCount];
+    ChunkInfoHandle*            mNextPtr[kListCount];
 
     void DetachFromChunkDir(bool evacuateFlag) {
         if (mChunkDirList == ChunkDirInfo::kChunkDirListNone) {
@@ -1270,6 +1312,8 @@ private:
     }
     friend class QCDLListOp<ChunkInfoHandle, 0>;
     friend class QCDLListOp<ChunkInfoHandle, 1>;
+    friend class QCDLListOp<ChunkInfoHandle,
+        ChunkManager::kChecksumsCacheListIdx>;
 private:
     ChunkInfoHandle(const  ChunkInfoHandle&);
     ChunkInfoHandle& operator=(const  ChunkInfoHandle&);
@@ -1370,14 +1414,129 @@ ChunkManager::LruUpdate(ChunkInfoHandle& cih)
 }
 
 inline void
-ChunkManager::Release(ChunkInfoHandle& cih)
+ChunkManager::ChecksumsCacheRemove(ChunkInfoHandle& cih)
 {
-    cih.Release(mChunkInfoLists);
+    if (ChecksumsCacheList::IsInList(mChecksumsCacheList, cih)) {
+        ChecksumsCacheList::Remove(mChecksumsCacheList, cih);
+        assert(0 < mChecksumsCacheCount);
+        mChecksumsCacheCount--;
+    }
+}
+
+inline void
+ChunkManager::Release(ChunkInfoHandle& cih, bool cacheChecksumsFlag)
+{
+    ChecksumsCacheRemove(cih);
+    WriteBlockCacheRemove(cih);
+    // Keep the checksums of stable chunks in memory in order to avoid
+    // re-reading chunk header on the subsequent open.
+    const bool keepChecksumsFlag =
+        cacheChecksumsFlag &&
+        0 < mChecksumsCacheMaxSize &&
+        0 <= cih.chunkInfo.chunkVersion &&
+        cih.IsStable() &&
+        ! cih.IsStale() &&
+        ! cih.IsBeingReplicated() &&
+        ! cih.IsRenameInFlight() &&
+        cih.chunkInfo.AreChecksumsLoaded();
+    cih.Release(mChunkInfoLists, keepChecksumsFlag);
+    if (keepChecksumsFlag) {
+        ChecksumsCacheList::PushBack(mChecksumsCacheList, cih);
+        mChecksumsCacheCount++;
+        ChecksumsCacheTrim();
+    }
+}
+
+void
+ChunkManager::ChecksumsCacheTrim()
+{
+    const int64_t maxCount = mChecksumsCacheMaxSize /
+        (int64_t)(MAX_CHUNK_CHECKSUM_BLOCKS * sizeof(uint32_t));
+    ChunkInfoHandle* cih;
+    while (maxCount < mChecksumsCacheCount &&
+            (cih = ChecksumsCacheList::PopFront(mChecksumsCacheList))) {
+        mChecksumsCacheCount--;
+        if (! cih->IsFileOpen()) {
+            cih->chunkInfo.UnloadChecksums();
+        }
+    }
+}
+
+bool
+ChunkManager::WriteBlockCacheGet(ChunkInfoHandle& cih, int64_t offset,
+    int size, IOBuffer& buf)
+{
+    // The cached block is valid only if no other write modified it: the
+    // checksum must match, and the remainder of the requested range, if any,
+    // must be past the end of chunk.
+    if (cih.writeBlockCacheOffset < 0 ||
+            cih.writeBlockCacheOffset != offset ||
+            ((int)CHECKSUM_BLOCKSIZE < size &&
+                offset + CHECKSUM_BLOCKSIZE < cih.chunkInfo.chunkSize) ||
+            cih.chunkInfo.chunkBlockChecksum[
+                OffsetToChecksumBlockNum(offset)] !=
+                cih.writeBlockCacheChecksum) {
+        return false;
+    }
+    // Copy the data, as the write path modifies buffers in place.
+    buf.Clear();
+    for (IOBuffer::iterator it = cih.writeBlockCache.begin();
+            it != cih.writeBlockCache.end();
+            ++it) {
+        buf.CopyIn(it->Consumer(), it->BytesConsumable());
+    }
+    assert(buf.BytesConsumable() == (int)CHECKSUM_BLOCKSIZE);
+    if ((int)CHECKSUM_BLOCKSIZE < size) {
+        buf.ZeroFill(size - CHECKSUM_BLOCKSIZE);
+    }
+    return true;
+}
+
+void
+ChunkManager::WriteBlockCachePut(ChunkInfoHandle& cih, int64_t offset,
+    const IOBuffer& buf, uint32_t checksum)
+{
+    if (cih.writeBlockCacheOffset < 0) {
+        if (mWriteBlockCacheMaxCount <= mWriteBlockCacheCount) {
+            return;
+        }
+        mWriteBlockCacheCount++;
+    }
+    // The last checksum block of the buffer is cached.
+    int skip = buf.BytesConsumable() - (int)CHECKSUM_BLOCKSIZE;
+    assert(0 <= skip);
+    cih.writeBlockCache.Clear();
+    for (IOBuffer::iterator it = buf.begin(); it != buf.end(); ++it) {
+        const int nb = it->BytesConsumable();
+        if (nb <= skip) {
+            skip -= nb;
+            continue;
+        }
+        cih.writeBlockCache.CopyIn(it->Consumer() + skip, nb - skip);
+        skip = 0;
+    }
+    cih.writeBlockCacheOffset   = offset;
+    cih.writeBlockCacheChecksum = checksum;
+}
+
+void
+ChunkManager::WriteBlockCacheRemove(ChunkInfoHandle& cih)
+{
+    if (cih.writeBlockCacheOffset < 0) {
+        return;
+    }
+    cih.writeBlockCache.Clear();
+    cih.writeBlockCacheOffset   = -1;
+    cih.writeBlockCacheChecksum = 0;
+    assert(0 < mWriteBlockCacheCount);
+    mWriteBlockCacheCount--;
 }
 
 inline void
 ChunkManager::DeleteSelf(ChunkInfoHandle& cih)
 {
+    ChecksumsCacheRemove(cih);
+    WriteBlockCacheRemove(cih);
     cih.Delete(mChunkInfoLists);
 }
 
@@ -1431,6 +1590,12 @@ inline void
 ChunkManager::MakeStale(ChunkInfoHandle& cih,
     bool forceDeleteFlag, bool evacuatedFlag, KfsOp* op)
 {
+    if (ChecksumsCacheList::IsInList(mChecksumsCacheList, cih)) {
+        ChecksumsCacheRemove(cih);
+        if (! cih.IsFileOpen()) {
+            cih.chunkInfo.UnloadChecksums();
+        }
+    }
     cih.MakeStale(mChunkInfoLists,
         (! forceDeleteFlag && ! mForceDeleteStaleChunksFlag) ||
         (evacuatedFlag && mKeepEvacuatedChunksFlag),
@@ -1441,9 +1606,12 @@ ChunkManager::MakeStale(ChunkInfoHandle& cih,
 }
 
 void
-ChunkInfoHandle::Release(ChunkInfoHandle::ChunkLists* chunkInfoLists)
+ChunkInfoHandle::Release(ChunkInfoHandle::ChunkLists* chunkInfoLists,
+    bool keepChecksumsFlag)
 {
-    chunkInfo.UnloadChecksums();
+    if (! keepChecksumsFlag) {
+        chunkInfo.UnloadChecksums();
+    }
     if (! IsFileOpen()) {
         if (dataFH) {
             dataFH.reset();
@@ -1782,6 +1950,17 @@ ChunkManager::ChunkManager()
       mChunkTable(),
       mObjTable(),
       mMaxIORequestSize(4 << 20),
+      mChecksumsCacheCount(0),
+      mChecksumsCacheMaxSize(32 << 20),
+      mWriteBlockCacheCount(0),
+      mWriteBlockCacheMaxCount(128),
+      mScrubBytesPerSec(0),
+      mScrubMaxPendingRequests(4),
+      mScrubMaxBufferWaitUsecs(50000),
+      mScrubStateFileName(),
+      mScrubStateSaveIntervalSecs(300),
+      mNextScrubStateSaveTime(0),
+      mScrubStateLoadedFlag(false),
       mNextChunkDirsCheckTime(globalNetManager().Now() - 360000),
       mChunkDirsCheckIntervalSecs(120),
       mNextGetFsSpaceAvailableTime(globalNetManager().Now() - 360000),
@@ -1841,6 +2020,9 @@ ChunkManager::ChunkManager()
       mFileSystemId(-1),
       mFileSystemIdSuffix(),
       mFsIdFileNamePrefix("0-fsid-"),
+      mDirInventoryFileName(),
+      mDirInventoryWriteIntervalSecs(600),
+      mNextDirInventoryWriteTime(globalNetManager().Now() + 360000),
       mDirCheckerIoTimeoutSec(-1),
       mDirCheckFailureSimulatorInterval(-1),
       mChunkSizeSkipHeaderVerifyFlag(false),
@@ -1865,6 +2047,7 @@ ChunkManager::ChunkManager()
     for (int i = 0; i < kChunkInfoListCount; i++) {
         ChunkList::Init(mChunkInfoLists[i]);
     }
+    ChecksumsCacheList::Init(mChecksumsCacheList);
     globalNetManager().SetMaxAcceptsPerRead(4096);
 }
 
@@ -1963,6 +2146,9 @@ ChunkManager::Shutdown()
         usleep(10000);
     }
     ScavengePendingWrites(time(0) + 2 * mMaxPendingWriteLruSecs);
+    DirInventories inventories;
+    const bool     kChangedOnlyFlag = false;
+    GetDirInventories(inventories, kChangedOnlyFlag);
     ClearTable(mObjTable);
     ClearTable(mChunkTable);
     gAtomicRecordAppendManager.Shutdown();
@@ -1984,6 +2170,73 @@ ChunkManager::Shutdown()
             "DiskIo::Shutdown failure: " << errMsg <<
         KFS_LOG_EOM;
     }
+    SaveDirInventories(inventories);
+}
+
+void
+ChunkManager::GetDirInventories(ChunkManager::DirInventories& inventories,
+    bool changedOnlyFlag)
+{
+    inventories.clear();
+    if (mDirInventoryFileName.empty()) {
+        return;
+    }
+    // Only directories with all chunks stable and readable qualify. Writes
+    // into non stable chunks do not change directory modification time.
+    // Directory modification time is recorded here, and inventory is not
+    // written if the directory was modified after this point, in order to
+    // detect possible concurrent modifications. Only the chunk lists of the
+    // directories modified since the last successfully written inventory are
+    // traversed with changed only flag set.
+    for (ChunkDirs::iterator it = mChunkDirs.begin();
+            it != mChunkDirs.end(); ++it) {
+        if (it->availableSpace < 0) {
+            continue;
+        }
+        const int64_t changeTime = DirChecker::GetDirChangeTime(it->dirname);
+        if (changeTime < 0 ||
+                (changedOnlyFlag && changeTime == it->inventoryChangeTime)) {
+            continue;
+        }
+        DirInventories::mapped_type& inventory = inventories[it->dirname];
+        inventory.first = changeTime;
+        bool excludeFlag = false;
+        for (int i = 0; i < ChunkDirInfo::kChunkDirListCount &&
+                ! excludeFlag; i++) {
+            ChunkDirList::Iterator cit(it->chunkLists[i]);
+            const ChunkInfoHandle* cih;
+            while ((cih = cit.Next())) {
+                if (cih->chunkInfo.chunkVersion < 0) {
+                    continue; // Object store blocks are not in inventory.
+                }
+                if (! cih->IsStable() || ! cih->IsChunkReadable() ||
+                        cih->IsRenameInFlight() || cih->IsBeingReplicated()) {
+                    excludeFlag = true;
+                    break;
+                }
+                DirChecker::ChunkInfo& ci = inventory.second.PushBack(
+                    DirChecker::ChunkInfo());
+                ci.mFileId       = cih->chunkInfo.fileId;
+                ci.mChunkId      = cih->chunkInfo.chunkId;
+                ci.mChunkVersion = cih->chunkInfo.chunkVersion;
+                ci.mChunkSize    = cih->chunkInfo.chunkSize;
+            }
+        }
+        if (excludeFlag) {
+            inventories.erase(it->dirname);
+        }
+    }
+}
+
+void
+ChunkManager::SaveDirInventories(ChunkManager::DirInventories& inventories)
+{
+    for (DirInventories::const_iterator it = inventories.begin();
+            it != inventories.end(); ++it) {
+        DirChecker::WriteInventory(it->first, mDirInventoryFileName,
+            mFileSystemId, it->second.first, it->second.second);
+    }
+    inventories.clear();
 }
 
 bool
@@ -2025,6 +2278,28 @@ ChunkManager::SetParameters(const Properties& prop)
     mInactiveFdFullScanIntervalSecs = max(0, (int)prop.getValue(
         "chunkServer.inactiveFdFullScanIntervalSecs",
         (double)mInactiveFdFullScanIntervalSecs));
+    mChecksumsCacheMaxSize = max(int64_t(0), (int64_t)prop.getValue(
+        "chunkServer.chunkChecksumsCacheMaxSize",
+        (double)mChecksumsCacheMaxSize));
+    ChecksumsCacheTrim();
+    mWriteBlockCacheMaxCount = max(0, prop.getValue(
+        "chunkServer.writeBlockCacheMaxCount",
+        mWriteBlockCacheMaxCount));
+    mScrubBytesPerSec = max(int64_t(0), (int64_t)prop.getValue(
+        "chunkServer.scrubber.bytesPerSec",
+        (double)mScrubBytesPerSec));
+    mScrubMaxPendingRequests = prop.getValue(
+        "chunkServer.scrubber.maxPendingRequests",
+        mScrubMaxPendingRequests);
+    mScrubMaxBufferWaitUsecs = (int64_t)prop.getValue(
+        "chunkServer.scrubber.maxBufferWaitUsecs",
+        (double)mScrubMaxBufferWaitUsecs);
+    mScrubStateFileName = prop.getValue(
+        "chunkServer.scrubber.stateFile",
+        mScrubStateFileName);
+    mScrubStateSaveIntervalSecs = max(1, prop.getValue(
+        "chunkServer.scrubber.stateSaveIntervalSecs",
+        mScrubStateSaveIntervalSecs));
     mMaxPendingWriteLruSecs = max(1, (int)prop.getValue(
         "chunkServer.maxPendingWriteLruSecs",
         (double)mMaxPendingWriteLruSecs));
@@ -2175,7 +2450,16 @@ ChunkManager::SetParameters(const Properties& prop)
     if (! mCheckDirWritableTmpFileName.empty()) {
         names.insert(mCheckDirWritableTmpFileName);
     }
+    mDirInventoryFileName = prop.getValue(
+        "chunkServer.dirInventoryFileName", mDirInventoryFileName);
+    if (! mDirInventoryFileName.empty()) {
+        names.insert(mDirInventoryFileName);
+    }
     mDirChecker.SetIgnoreFileNames(names);
+    mDirChecker.SetInventoryFileName(mDirInventoryFileName);
+    mDirInventoryWriteIntervalSecs = prop.getValue(
+        "chunkServer.dirInventoryWriteIntervalSecs",
+        mDirInventoryWriteIntervalSecs);
 
     gAtomicRecordAppendManager.SetParameters(prop);
 
@@ -2186,6 +2470,8 @@ ChunkManager::SetParameters(const Properties& prop)
         now + mChunkDirsCheckIntervalSecs);
     mNextSendChunDirInfoTime = min(mNextSendChunDirInfoTime,
         now + mSendChunDirInfoIntervalSecs);
+    mNextDirInventoryWriteTime = min(mNextDirInventoryWriteTime,
+        now + mDirInventoryWriteIntervalSecs);
     mNextInactiveFdFullScanTime = min(mNextInactiveFdFullScanTime,
         now + mInactiveFdFullScanIntervalSecs);
     mAllocDefaultMinTier = prop.getValue(
@@ -3018,6 +3304,10 @@ ChunkManager::ReadChunkMetadata(
 
     LruUpdate(*cih);
     if (cih->chunkInfo.AreChecksumsLoaded()) {
+        if (ChecksumsCacheList::IsInList(mChecksumsCacheList, *cih)) {
+            ChecksumsCacheRemove(*cih);
+            mCounters.mChunkHeaderCacheHitCount++;
+        }
         int res = 0;
         cb->HandleEvent(EVENT_CMD_DONE, &res);
         return 0;
@@ -3057,6 +3347,7 @@ ChunkManager::ReadChunkMetadata(
         return res;
     }
     cih->readChunkMetaOp = rcm;
+    mCounters.mChunkHeaderReadCount++;
     return 0;
 }
 
@@ -3373,6 +3664,7 @@ ChunkManager::TruncateChunk(kfsChunkId_t chunkId, int64_t chunkSize)
     // XXX: Could do better; recompute the checksum for this last block
     cih->chunkInfo.chunkBlockChecksum[lastChecksumBlock] = 0;
     cih->SetMetaDirty();
+    WriteBlockCacheRemove(*cih);
 
     return 0;
 }
@@ -4145,7 +4437,7 @@ ChunkManager::ReadChunk(ReadOp* op)
     if (! d) {
         return -ESERVERBUSY;
     }
-
+    d->SetLowPriority(op->scrubOp || (op->wop && op->wop->isFromReReplication));
     op->diskIo.reset(d);
 
     // schedule a read based on the chunk size
@@ -4255,6 +4547,10 @@ ChunkManager::WriteChunk(WriteOp* op, const DiskIo::FilePtr* filePtr /* = 0 */)
         } else {
             op->checksums = ComputeChecksums(&op->dataBuf, numBytesIO);
         }
+        if (offset < cih->writeBlockCacheOffset + CHECKSUM_BLOCKSIZE &&
+                cih->writeBlockCacheOffset < offset + numBytesIO) {
+            WriteBlockCacheRemove(*cih);
+        }
     } else {
         if ((size_t)numBytesIO >= (size_t) CHECKSUM_BLOCKSIZE) {
             op->statusMsg = "invalid request position or size";
@@ -4265,19 +4561,28 @@ ChunkManager::WriteChunk(WriteOp* op, const DiskIo::FilePtr* filePtr /* = 0 */)
             2 * CHECKSUM_BLOCKSIZE : CHECKSUM_BLOCKSIZE;
 
         op->checksums.clear();
+        IOBuffer data;
         // The checksum block we are after is beyond the current
         // end-of-chunk.  So, treat that as a 0-block and splice in.
         if (offset - off >= cih->chunkInfo.chunkSize) {
-            IOBuffer data;
             data.ReplaceKeepBuffersFull(&op->dataBuf, off, numBytesIO);
             data.ZeroFill(blkSize - (off + numBytesIO));
             op->dataBuf.Move(&data);
+        } else if (! op->rop &&
+                WriteBlockCacheGet(*cih, offset - off, blkSize, data)) {
+            // The block is the one written by the previous small write, use
+            // it instead of reading it back from the disk.
+            mCounters.mWriteBlockCacheHitCount++;
+            data.ReplaceKeepBuffersFull(&op->dataBuf, off, numBytesIO);
+            op->dataBuf.Clear();
+            op->dataBuf.Move(&data);
         } else {
             // Need to read the data block over which the checksum is
             // computed.
             if (! op->rop) {
                 // issue a read
                 ReadOp *rop = new ReadOp(op, offset - off, blkSize);
+                mCounters.mWriteBlockCacheMissCount++;
                 KFS_LOG_STREAM_DEBUG <<
                     "write triggered a read for offset=" << offset <<
                 KFS_LOG_EOM;
@@ -4313,6 +4618,16 @@ ChunkManager::WriteChunk(WriteOp* op, const DiskIo::FilePtr* filePtr /* = 0 */)
 
         assert(op->dataBuf.BytesConsumable() == (int) blkSize);
         op->checksums = ComputeChecksums(&op->dataBuf, blkSize);
+        // Keep the last block if the write ends in the middle of it, in
+        // order to handle the next sequential write without reading it.
+        if ((offset + numBytesIO) % CHECKSUM_BLOCKSIZE != 0 &&
+                ! op->isFromReReplication) {
+            WriteBlockCachePut(*cih,
+                offset - off + blkSize - CHECKSUM_BLOCKSIZE,
+                op->dataBuf, op->checksums.back());
+        } else {
+            WriteBlockCacheRemove(*cih);
+        }
 
         // Trim data at the buffer boundary from the beginning, to make write
         // offset close to where we were asked from.
@@ -4325,8 +4640,10 @@ ChunkManager::WriteChunk(WriteOp* op, const DiskIo::FilePtr* filePtr /* = 0 */)
 
     DiskIo* const d = SetupDiskIo(cih, op);
     if (! d) {
+        WriteBlockCacheRemove(*cih);
         return -ESERVERBUSY;
     }
+    d->SetLowPriority(op->isFromReReplication);
     op->diskIo.reset(d);
 
     /*
@@ -4347,6 +4664,7 @@ ChunkManager::WriteChunk(WriteOp* op, const DiskIo::FilePtr* filePtr /* = 0 */)
         cih->StartWrite(op);
     } else {
         op->diskIo.reset();
+        WriteBlockCacheRemove(*cih);
         cih->WriteStats(res, numBytesIO, 0);
         ReportIOFailure(cih, res);
     }
@@ -4836,6 +5154,7 @@ ChunkManager::ReportIOFailure(ChunkInfoHandle* cih, int err)
 void
 ChunkManager::ChunkIOFailed(ChunkInfoHandle* cih, int err)
 {
+    WriteBlockCacheRemove(*cih);
     NotifyMetaCorruptedChunk(cih, err);
     StaleChunk(cih);
 }
@@ -5551,10 +5870,265 @@ ChunkManager::Timeout()
         SendChunkDirInfo();
         mNextSendChunDirInfoTime = now + mSendChunDirInfoIntervalSecs;
     }
+    if (mNextDirInventoryWriteTime < now) {
+        mNextDirInventoryWriteTime = now + mDirInventoryWriteIntervalSecs;
+        // Write inventories of the modified directories periodically, in
+        // order to speed up restart after crash.
+        if (! mDirInventoryFileName.empty() &&
+                0 < mDirInventoryWriteIntervalSecs) {
+            // Update change times only after the inventories are written,
+            // in order to retry failed writes.
+            DirChecker::DirChangeTimes written;
+            mDirChecker.GetWrittenInventories(written);
+            for (ChunkDirs::iterator it = mChunkDirs.begin();
+                    ! written.empty() && it != mChunkDirs.end(); ++it) {
+                DirChecker::DirChangeTimes::iterator const wit =
+                    written.find(it->dirname);
+                if (wit != written.end()) {
+                    it->inventoryChangeTime = wit->second;
+                    written.erase(wit);
+                }
+            }
+            DirInventories inventories;
+            const bool     kChangedOnlyFlag = true;
+            GetDirInventories(inventories, kChangedOnlyFlag);
+            mDirChecker.ScheduleWriteInventories(mFileSystemId, inventories);
+        }
+    }
+    Scrub(now);
     gLeaseClerk.Timeout();
     gAtomicRecordAppendManager.Timeout();
 }
 
+void
+ChunkManager::Scrub(time_t now)
+{
+    if (mScrubBytesPerSec <= 0) {
+        return;
+    }
+    if (! mScrubStateLoadedFlag) {
+        mScrubStateLoadedFlag = true;
+        LoadScrubState();
+    }
+    const int64_t nowUsecs = microseconds();
+    for (ChunkDirs::iterator it = mChunkDirs.begin();
+            it < mChunkDirs.end();
+            ++it) {
+        ScrubDir(*it, now, nowUsecs);
+    }
+    if (! mScrubStateFileName.empty() && mNextScrubStateSaveTime <= now) {
+        mNextScrubStateSaveTime = now + mScrubStateSaveIntervalSecs;
+        SaveScrubState();
+    }
+}
+
+void
+ChunkManager::ScrubDir(ChunkDirInfo& dir, time_t now, int64_t nowUsecs)
+{
+    // Accrue read byte budget according to the time elapsed since the last
+    // update. Limit the budget to one second worth of reads, in order not to
+    // burst after the scrub was idle or deferred. The budget goes negative
+    // when a chunk larger than the budget is scrubbed.
+    if (dir.scrubBudgetTime <= 0) {
+        dir.scrubByteBudget = mScrubBytesPerSec;
+    } else if (dir.scrubBudgetTime < nowUsecs) {
+        dir.scrubByteBudget = min(mScrubBytesPerSec, dir.scrubByteBudget +
+            (int64_t)((double)(nowUsecs - dir.scrubBudgetTime) *
+                (double)mScrubBytesPerSec * 1e-6));
+    }
+    dir.scrubBudgetTime = nowUsecs;
+    if (dir.scrubInFlightFlag || dir.scrubByteBudget <= 0 ||
+            now < dir.nextScrubTime ||
+            dir.availableSpace < 0 || ! dir.diskQueue ||
+            dir.evacuateFlag) {
+        return;
+    }
+    int     freeRequestCount = 0;
+    int     requestCount     = 0;
+    int64_t readBlockCount   = 0;
+    int64_t writeBlockCount  = 0;
+    int     blockSize        = 0;
+    // Yield to the foreground io if the buffer manager is waiting.
+    if ((0 < mScrubMaxBufferWaitUsecs &&
+                mScrubMaxBufferWaitUsecs <
+                    DiskIo::GetBufferManager().GetWaitingAvgUsecs()) ||
+            (0 <= mScrubMaxPendingRequests &&
+                DiskIo::GetDiskQueuePendingCount(
+                    dir.diskQueue,
+                    freeRequestCount,
+                    requestCount,
+                    readBlockCount,
+                    writeBlockCount,
+                    blockSize) &&
+                mScrubMaxPendingRequests < requestCount)) {
+        mCounters.mScrubDeferCount++;
+        dir.nextScrubTime = now + 1;
+        return;
+    }
+    ScrubNext(dir, now);
+}
+
+static inline bool
+IsScrubCandidate(const ChunkInfoHandle& cih)
+{
+    return (
+        0 <= cih.chunkInfo.chunkVersion &&
+        0 < cih.chunkInfo.chunkSize &&
+        cih.IsChunkReadable() &&
+        ! cih.IsBeingReplicated() &&
+        ! cih.IsStale()
+    );
+}
+
+void
+ChunkManager::ScrubNext(ChunkDirInfo& dir, time_t now)
+{
+    // Scrub in chunk id order, in order to be able to resume after restart.
+    // Each pass iterates over the sorted snapshot of the directory chunk ids
+    // taken at the start of the pass. The chunks added during the pass are
+    // scrubbed by the next pass.
+    ChunkInfoHandle* next        = 0;
+    bool             newPassFlag = false;
+    while (! next) {
+        if (dir.scrubChunkIds.size() <= dir.scrubPos) {
+            if (newPassFlag) {
+                break;
+            }
+            newPassFlag = true;
+            if (! dir.scrubChunkIds.empty()) {
+                KFS_LOG_STREAM_INFO <<
+                    "scrub: " << dir.dirname << " pass complete" <<
+                KFS_LOG_EOM;
+                dir.scrubChunkId = -1;
+            }
+            dir.scrubChunkIds.clear();
+            ChunkDirList::Iterator it(
+                dir.chunkLists[ChunkDirInfo::kChunkDirList]);
+            const ChunkInfoHandle* cih;
+            while ((cih = it.Next())) {
+                if (IsScrubCandidate(*cih)) {
+                    dir.scrubChunkIds.push_back(cih->chunkInfo.chunkId);
+                }
+            }
+            sort(dir.scrubChunkIds.begin(), dir.scrubChunkIds.end());
+            dir.scrubPos = upper_bound(
+                dir.scrubChunkIds.begin(), dir.scrubChunkIds.end(),
+                dir.scrubChunkId) - dir.scrubChunkIds.begin();
+            if (dir.scrubChunkIds.size() <= dir.scrubPos) {
+                dir.scrubPos     = 0;
+                dir.scrubChunkId = -1;
+            }
+            continue;
+        }
+        ChunkInfoHandle** const ci =
+            mChunkTable.Find(dir.scrubChunkIds[dir.scrubPos++]);
+        if (ci && &(*ci)->GetDirInfo() == &dir && IsScrubCandidate(**ci)) {
+            next = *ci;
+        }
+    }
+    if (! next) {
+        dir.scrubChunkIds.clear();
+        dir.scrubPos      = 0;
+        dir.scrubChunkId  = -1;
+        dir.nextScrubTime = now + 60;
+        return;
+    }
+    // Close the chunk file once scrub completes if the scrub opens it, and
+    // do not let the scrub reads add checksums into the checksums cache.
+    dir.scrubReleaseFlag       = ! next->IsFileOpen();
+    dir.scrubKeepChecksumsFlag =
+        ChecksumsCacheList::IsInList(mChecksumsCacheList, *next);
+    GetChunkMetadataOp* const op = new GetChunkMetadataOp();
+    op->chunkId        = next->chunkInfo.chunkId;
+    op->readVerifyFlag = true;
+    op->clnt           = &dir.scrubCb;
+    dir.scrubChunkId      = op->chunkId;
+    dir.scrubInFlightFlag = true;
+    dir.scrubStartFlag    = true;
+    op->Execute();
+    dir.scrubStartFlag    = false;
+}
+
+void
+ChunkManager::ScrubDone(ChunkDirInfo& dir, const GetChunkMetadataOp& op)
+{
+    mCounters.mScrubChunkCount++;
+    mCounters.mScrubByteCount += op.numBytesScrubbed;
+    dir.scrubByteBudget       -= op.numBytesScrubbed;
+    if (op.status < 0 && op.status != -EBADF && op.status != -EBADVERS &&
+            op.status != -EAGAIN) {
+        // Checksum mismatch and io errors are reported to the meta server
+        // by ReadChunkDone() and ChunkIOFailed().
+        mCounters.mScrubErrorCount++;
+        KFS_LOG_STREAM_ERROR <<
+            "scrub: " << dir.dirname <<
+            " chunk: "   << op.chunkId <<
+            " version: " << op.chunkVersion <<
+            " status: "  << op.status <<
+        KFS_LOG_EOM;
+    }
+    ChunkInfoHandle** const ci = dir.scrubReleaseFlag ?
+        mChunkTable.Find(op.chunkId) : 0;
+    ChunkInfoHandle* const  cih = ci ? *ci : 0;
+    if (cih && cih->IsFileOpen() && cih->IsStable() &&
+            ! cih->IsFileInUse() && ! cih->IsBeingReplicated() &&
+            ! cih->IsStale() && ! cih->SyncMeta()) {
+        Release(*cih, dir.scrubKeepChecksumsFlag);
+    }
+    // Start the next chunk without waiting for the timer, unless the op
+    // completed synchronously, in order to avoid unbounded recursion.
+    if (! dir.scrubStartFlag && 0 < mScrubBytesPerSec &&
+            0 < dir.scrubByteBudget) {
+        ScrubDir(dir, globalNetManager().Now(), microseconds());
+    }
+}
+
+void
+ChunkManager::LoadScrubState()
+{
+    if (mScrubStateFileName.empty()) {
+        return;
+    }
+    ifstream ifs(mScrubStateFileName.c_str());
+    string   line;
+    while (getline(ifs, line)) {
+        istringstream is(line);
+        kfsChunkId_t  chunkId = -1;
+        string        dirname;
+        if (! (is >> chunkId) || ! getline(is >> std::ws, dirname)) {
+            continue;
+        }
+        for (ChunkDirs::iterator it = mChunkDirs.begin();
+                it < mChunkDirs.end();
+                ++it) {
+            if (it->dirname == dirname) {
+                it->scrubChunkId = chunkId;
+                break;
+            }
+        }
+    }
+}
+
+void
+ChunkManager::SaveScrubState()
+{
+    const string tmpName = mScrubStateFileName + ".tmp";
+    ofstream ofs(tmpName.c_str(), ofstream::out | ofstream::trunc);
+    for (ChunkDirs::const_iterator it = mChunkDirs.begin();
+            it < mChunkDirs.end();
+            ++it) {
+        ofs << it->scrubChunkId << " " << it->dirname << "\n";
+    }
+    ofs.close();
+    if (! ofs || rename(tmpName.c_str(), mScrubStateFileName.c_str())) {
+        const int err = errno;
+        KFS_LOG_STREAM_ERROR <<
+            "scrub: failed to write " << mScrubStateFileName <<
+            ": " << QCUtils::SysError(err) <<
+        KFS_LOG_EOM;
+    }
+}
+
 template<typename TT, typename WT> void
 ChunkManager::ScavengePendingWrites(
     time_t now, TT& table, WT& pendingWrites)
@@ -6185,6 +6759,20 @@ ChunkManager::FindDeviceBufferManager(kfsChunkId_t chunkId, int64_t chunkVersion
     return (dir ? DiskIo::GetDiskBufferManager(dir->diskQueue) : 0);
 }
 
+int
+ChunkManager::ChunkDirInfo::ScrubDone(int code, void* data)
+{
+    if (code != EVENT_CMD_DONE || ! data || ! scrubInFlightFlag) {
+        die("ScrubDone invalid completion");
+        return -1;
+    }
+    GetChunkMetadataOp* const op = reinterpret_cast<GetChunkMetadataOp*>(data);
+    scrubInFlightFlag = false;
+    gChunkManager.ScrubDone(*this, *op);
+    delete op;
+    return 0;
+}
+
 int
 ChunkManager::ChunkDirInfo::CheckDirDone(int code, void* data)
 {
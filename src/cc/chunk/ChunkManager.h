@@ -91,6 +91,14 @@ public:
         Counter mReadSkipDiskVerifyErrorCount;
         Counter mReadSkipDiskVerifyByteCount;
         Counter mReadSkipDiskVerifyChecksumByteCount;
+        Counter mChunkHeaderReadCount;
+        Counter mChunkHeaderCacheHitCount;
+        Counter mScrubChunkCount;
+        Counter mScrubByteCount;
+        Counter mScrubErrorCount;
+        Counter mScrubDeferCount;
+        Counter mWriteBlockCacheHitCount;
+        Counter mWriteBlockCacheMissCount;
 
         void Clear()
         {
@@ -109,6 +117,14 @@ public:
             mReadSkipDiskVerifyErrorCount        = 0;
             mReadSkipDiskVerifyByteCount         = 0;
             mReadSkipDiskVerifyChecksumByteCount = 0;
+            mChunkHeaderReadCount                = 0;
+            mChunkHeaderCacheHitCount            = 0;
+            mScrubChunkCount                     = 0;
+            mScrubByteCount                      = 0;
+            mScrubErrorCount                     = 0;
+            mScrubDeferCount                     = 0;
+            mWriteBlockCacheHitCount             = 0;
+            mWriteBlockCacheMissCount            = 0;
         }
     };
 
@@ -384,6 +400,9 @@ public:
         kChunkInfoListCount
     };
     typedef ChunkInfoHandle* ChunkLists[kChunkInfoHandleListCount];
+    // Chunk info handle list index past chunk lru and chunk directory lists.
+    enum { kChecksumsCacheListIdx = kChunkInfoHandleListCount + 1 };
+    typedef ChunkInfoHandle* ChecksumsCacheLists[kChecksumsCacheListIdx + 1];
     struct ChunkDirInfo;
 
     const string& GetEvacuateFileName() const
@@ -862,6 +881,24 @@ private:
     size_t mMaxIORequestSize;
     /// Chunk lru, and stale chunks list heads.
     ChunkLists mChunkInfoLists[kChunkInfoListCount];
+    /// Lru of closed stable chunks with checksums kept in memory.
+    ChecksumsCacheLists mChecksumsCacheList;
+    int64_t             mChecksumsCacheCount;
+    int64_t             mChecksumsCacheMaxSize;
+    /// Last partially written checksum block of the chunks being written,
+    /// used in place of the read for the next small sequential write.
+    int                 mWriteBlockCacheCount;
+    int                 mWriteBlockCacheMaxCount;
+
+    /// Background scrub: per chunk directory read and verify rate, 0 --
+    /// disabled. The scrub position is periodically saved into the state file.
+    int64_t mScrubBytesPerSec;
+    int     mScrubMaxPendingRequests;
+    int64_t mScrubMaxBufferWaitUsecs;
+    string  mScrubStateFileName;
+    int     mScrubStateSaveIntervalSecs;
+    time_t  mNextScrubStateSaveTime;
+    bool    mScrubStateLoadedFlag;
 
     /// Periodically do an IO and check the chunk dirs and identify failed drives
     time_t mNextChunkDirsCheckTime;
@@ -928,6 +965,9 @@ private:
     int64_t    mFileSystemId;
     string     mFileSystemIdSuffix;
     string     mFsIdFileNamePrefix;
+    string     mDirInventoryFileName;
+    int        mDirInventoryWriteIntervalSecs;
+    time_t     mNextDirInventoryWriteTime;
     int        mDirCheckerIoTimeoutSec;
     int        mDirCheckFailureSimulatorInterval;
     bool       mChunkSizeSkipHeaderVerifyFlag;
@@ -949,7 +989,20 @@ private:
     ChunkHeaderBuffer mChunkHeaderBuffer;
 
     inline void Delete(ChunkInfoHandle& cih);
-    inline void Release(ChunkInfoHandle& cih);
+    inline void Release(ChunkInfoHandle& cih, bool cacheChecksumsFlag = true);
+    inline void ChecksumsCacheRemove(ChunkInfoHandle& cih);
+    void ChecksumsCacheTrim();
+    bool WriteBlockCacheGet(ChunkInfoHandle& cih, int64_t offset,
+        int size, IOBuffer& buf);
+    void WriteBlockCachePut(ChunkInfoHandle& cih, int64_t offset,
+        const IOBuffer& buf, uint32_t checksum);
+    void WriteBlockCacheRemove(ChunkInfoHandle& cih);
+    void Scrub(time_t now);
+    void ScrubDir(ChunkDirInfo& dir, time_t now, int64_t nowUsecs);
+    void ScrubNext(ChunkDirInfo& dir, time_t now);
+    void ScrubDone(ChunkDirInfo& dir, const GetChunkMetadataOp& op);
+    void LoadScrubState();
+    void SaveScrubState();
 
     /// When a checkpoint file is read, update the mChunkTable[] to
     /// include a mapping for cih->chunkInfo.chunkId.
@@ -1037,6 +1090,9 @@ private:
     void SetDirCheckerIoTimeout();
     template<typename T> ChunkDirInfo* GetDirForChunkT(T start, T end);
     template<typename T> void ClearTable(T& table);
+    typedef DirChecker::DirInventories DirInventories;
+    void GetDirInventories(DirInventories& inventories, bool changedOnlyFlag);
+    void SaveDirInventories(DirInventories& inventories);
     template<typename T> void RunIoCompletion(T& table);
 
     static bool sExitDebugCheckFlag;
@@ -179,6 +179,8 @@ ClientManager gClientManager;
 
 ClientManager::ClientManager()
     : mAcceptorPtr(0),
+      mIpV6OnlyFlag(false),
+      mThreadAcceptFlag(false),
       mIoTimeoutSec(5 * 60),
       mIdleTimeoutSec(10 * 60),
       mMaxClientCount(64 << 10),
@@ -206,17 +208,24 @@ ClientManager::BindAcceptor(
     bool                  ipV6OnlyFlag,
     int                   inThreadCount,
     int                   inFirstCpuIdx,
+    bool                  inThreadAcceptFlag,
     QCMutex*&             outMutexPtr)
 {
     Stop();
     delete mAcceptorPtr;
     delete [] mThreadsPtr;
-    mAcceptorPtr = 0;
-    mThreadsPtr  = 0;
-    mThreadCount = 0;
+    mAcceptorPtr      = 0;
+    mThreadsPtr       = 0;
+    mThreadCount      = 0;
+    mIpV6OnlyFlag     = ipV6OnlyFlag;
+    mThreadAcceptFlag = inThreadAcceptFlag && 0 < inThreadCount;
     const bool kBindOnlyFlag = true;
+    // With thread accept, each client thread has its own listening socket
+    // bound to the same port, and the kernel distributes the incoming
+    // connections between the listening sockets.
     mAcceptorPtr = new Acceptor(
-        globalNetManager(), clientListener, ipV6OnlyFlag, this, kBindOnlyFlag);
+        globalNetManager(), clientListener, ipV6OnlyFlag, this, kBindOnlyFlag,
+        mThreadAcceptFlag);
     const bool theOkFlag = mAcceptorPtr->IsAcceptorStarted();
     if (theOkFlag && 0 < inThreadCount) {
         static QCMutex sOpsMutex;
@@ -237,7 +246,16 @@ ClientManager::StartListening()
         return false;
     }
     mAcceptorPtr->StartListening();
-    return mAcceptorPtr->IsAcceptorStarted();
+    if (! mAcceptorPtr->IsAcceptorStarted()) {
+        return false;
+    }
+    if (mThreadAcceptFlag) {
+        for (int i = max(mFirstClientThreadIndex, 0); i < mThreadCount; i++) {
+            mThreadsPtr[i].StartAcceptor(
+                mAcceptorPtr->GetLocation(), mIpV6OnlyFlag);
+        }
+    }
+    return true;
 }
 
     void
@@ -249,6 +267,20 @@ ClientManager::Stop()
     /* virtual */ KfsCallbackObj*
 ClientManager::CreateKfsCallbackObj(
     NetConnectionPtr& inConnPtr)
+{
+    ClientThread* const theThreadPtr = GetNextClientThreadPtr();
+    ClientSM*     const theClientPtr = CreateClient(inConnPtr, theThreadPtr);
+    if (theClientPtr && theThreadPtr) {
+        inConnPtr.reset(); // Thread takes ownership.
+        theThreadPtr->Add(*theClientPtr);
+    }
+    return theClientPtr;
+}
+
+    ClientSM*
+ClientManager::CreateClient(
+    NetConnectionPtr& inConnPtr,
+    ClientThread*     inThreadPtr)
 {
     if (! inConnPtr || ! inConnPtr->IsGood()) {
         return 0;
@@ -265,16 +297,11 @@ ClientManager::CreateKfsCallbackObj(
     }
     mCounters.mAcceptCount++;
     mCounters.mClientCount++;
-    ClientThread* const theThreadPtr = GetNextClientThreadPtr();
-    ClientSM*     const theClientPtr = new ClientSM(inConnPtr, theThreadPtr);
+    ClientSM* const theClientPtr = new ClientSM(inConnPtr, inThreadPtr);
     if (! mAuth.Setup(*inConnPtr, *theClientPtr)) {
         delete theClientPtr;
         return 0;
     }
-    if (theThreadPtr) {
-        inConnPtr.reset(); // Thread takes ownership.
-        theThreadPtr->Add(*theClientPtr);
-    }
     return theClientPtr;
 }
 
@@ -108,10 +108,15 @@ public:
         bool                  ipV6OnlyFlag,
         int                   inThreadCount,
         int                   inFirstCpuIdx,
+        bool                  inThreadAcceptFlag,
         QCMutex*&             outMutexPtr);
     bool StartListening();
     virtual KfsCallbackObj* CreateKfsCallbackObj(
         NetConnectionPtr& inConnPtr);
+    // Invoked by the client thread acceptor with the client thread mutex held.
+    ClientSM* CreateClient(
+        NetConnectionPtr& inConnPtr,
+        ClientThread*     inThreadPtr);
     void GetCounters(
         Counters& outCounters) const;
     bool SetParameters(
@@ -223,6 +228,8 @@ private:
     class Auth;
 
     Acceptor*     mAcceptorPtr;
+    bool          mIpV6OnlyFlag;
+    bool          mThreadAcceptFlag;
     int           mIoTimeoutSec;
     int           mIdleTimeoutSec;
     int           mMaxClientCount;
@@ -25,6 +25,7 @@
 
 #include "ClientThread.h"
 #include "ClientSM.h"
+#include "ClientManager.h"
 #include "RemoteSyncSM.h"
 #include "Replicator.h"
 
@@ -37,6 +38,7 @@
 #include "qcdio/qcdebug.h"
 
 #include "kfsio/NetManager.h"
+#include "kfsio/Acceptor.h"
 #include "kfsio/IOBuffer.h"
 #include "kfsio/Globals.h"
 #include "kfsio/checksum.h"
@@ -46,6 +48,7 @@
 namespace KFS
 {
 using std::ostringstream;
+using libkfsio::globalNetManager;
 
     inline int
 ClientThreadListEntry::HandleRequest(
@@ -100,7 +103,10 @@ ClientThreadRemoteSyncListEntry::RemoveFromList(
     return inSyncSM.RemoveFromList();
 }
 
-class ClientThreadImpl : public QCRunnable, public NetManager::Dispatcher
+class ClientThreadImpl :
+    public QCRunnable,
+    public NetManager::Dispatcher,
+    public IAcceptorOwner
 {
 public:
     typedef ClientThread Outer;
@@ -177,6 +183,10 @@ public:
           mTmpSyncSMQueue(),
           mTmpRSReplicatorQueue(),
           mWakeupCnt(0),
+          mAcceptorPtr(0),
+          mAcceptorLocation(),
+          mAcceptorIpV6OnlyFlag(false),
+          mAcceptCount(0),
           mOuter(inOuter)
     {
         QCASSERT(GetMutex().IsOwned());
@@ -191,6 +201,7 @@ public:
         if (IsStarted()) {
             ClientThreadImpl::Stop();
         }
+        delete mAcceptorPtr;
     }
     void Add(
         ClientSM& inClient)
@@ -218,6 +229,32 @@ public:
             Wakeup();
         }
     }
+    void StartAcceptor(
+        const ServerLocation& inLocation,
+        bool                  inIpV6OnlyFlag)
+    {
+        QCASSERT(GetMutex().IsOwned());
+        mAcceptorLocation     = inLocation;
+        mAcceptorIpV6OnlyFlag = inIpV6OnlyFlag;
+        Wakeup();
+    }
+    virtual KfsCallbackObj* CreateKfsCallbackObj(
+        NetConnectionPtr& inConnPtr)
+    {
+        QCASSERT(! GetMutex().IsOwned());
+        StMutexLocker   theLocker(mOuter);
+        ClientSM* const theRetPtr =
+            gClientManager.CreateClient(inConnPtr, &mOuter);
+        if (theRetPtr) {
+            mAcceptCount++;
+        }
+        return theRetPtr;
+    }
+    int64_t GetAcceptCount() const
+    {
+        QCASSERT(GetMutex().IsOwned());
+        return mAcceptCount;
+    }
     virtual void Run()
     {
         QCMutex* const kNullMutexPtr         = 0;
@@ -289,7 +326,12 @@ public:
             }
         }
         if (! mRunFlag && ! mShutdownFlag) {
+            delete mAcceptorPtr;
+            mAcceptorPtr = 0;
             mNetManager.Shutdown();
+        } else if (! mAcceptorPtr && mAcceptorLocation.IsValid() &&
+                ! mShutdownFlag) {
+            StartAcceptorSelf();
         }
         mTmpDispatchQueue.clear();
         theCnt = 0;
@@ -513,6 +555,10 @@ private:
     TmpSyncSMQueue         mTmpSyncSMQueue;
     TmpRSReplicatorQueue   mTmpRSReplicatorQueue;
     volatile int           mWakeupCnt;
+    Acceptor*              mAcceptorPtr;
+    ServerLocation         mAcceptorLocation;
+    bool                   mAcceptorIpV6OnlyFlag;
+    int64_t                mAcceptCount;
     ClientThread&          mOuter;
     ClientThreadListEntry* mAddQueuePtr[kDispatchQueueCount];
     ClientThreadListEntry* mDispatchQueuePtr[kDispatchQueueCount];
@@ -521,6 +567,35 @@ private:
     static ClientThread* sCurrentClientThreadPtr;
     static int           sLockCnt;
 
+    void StartAcceptorSelf()
+    {
+        const bool kBindOnlyFlag  = false;
+        const bool kReusePortFlag = true;
+        mNetManager.SetMaxAcceptsPerRead(
+            globalNetManager().GetMaxAcceptsPerRead());
+        mAcceptorPtr = new Acceptor(
+            mNetManager,
+            mAcceptorLocation,
+            mAcceptorIpV6OnlyFlag,
+            this,
+            kBindOnlyFlag,
+            kReusePortFlag
+        );
+        if (mAcceptorPtr->IsAcceptorStarted()) {
+            KFS_LOG_STREAM_INFO <<
+                "client thread: accepting connections on: " <<
+                    mAcceptorLocation <<
+            KFS_LOG_EOM;
+            return;
+        }
+        KFS_LOG_STREAM_ERROR <<
+            "client thread: failed to start acceptor on: " <<
+                mAcceptorLocation <<
+        KFS_LOG_EOM;
+        delete mAcceptorPtr;
+        mAcceptorPtr = 0;
+        mAcceptorLocation = ServerLocation();
+    }
     void CheckQueueSize(
         int         inSize,
         const char* inNamePtr)
@@ -823,6 +898,20 @@ ClientThread::GetNetManager()
     return mImpl.GetNetManager();
 }
 
+    void
+ClientThread::StartAcceptor(
+    const ServerLocation& inLocation,
+    bool                  inIpV6OnlyFlag)
+{
+    mImpl.StartAcceptor(inLocation, inIpV6OnlyFlag);
+}
+
+    int64_t
+ClientThread::GetAcceptCount() const
+{
+    return mImpl.GetAcceptCount();
+}
+
     const QCThread&
 ClientThread::GetThread() const
 {
@@ -26,6 +26,8 @@
 #ifndef CLIENT_THREAD_H
 #define CLIENT_THREAD_H
 
+#include <stdint.h>
+
 class QCMutex;
 class QCThread;
 
@@ -38,6 +40,7 @@ class NetManager;
 class RemoteSyncSM;
 class RSReplicatorEntry;
 struct KfsOp;
+struct ServerLocation;
 
 class ClientThreadImpl;
 class ClientThread
@@ -77,6 +80,12 @@ public:
     void Add(
         ClientSM& inClient);
     NetManager& GetNetManager();
+    // Start accepting client connections in this thread, with listening
+    // socket bound to the specified location with SO_REUSEPORT.
+    void StartAcceptor(
+        const ServerLocation& inLocation,
+        bool                  inIpV6OnlyFlag);
+    int64_t GetAcceptCount() const;
     void Lock();
     void Unlock();
     const QCThread& GetThread() const;
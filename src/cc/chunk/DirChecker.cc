@@ -43,6 +43,7 @@
 #include "qcdio/qcdebug.h"
 
 #include "kfsio/PrngIsaac64.h"
+#include "kfsio/checksum.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
@@ -54,20 +55,27 @@
 #include <utility>
 #include <map>
 #include <deque>
+#include <vector>
+#include <algorithm>
 
 namespace KFS
 {
 
 using std::pair;
 using std::make_pair;
+using std::vector;
+using std::sort;
+using std::binary_search;
 
 class DirChecker::Impl : public QCRunnable
 {
 public:
-    typedef DirChecker::LockFd    LockFd;
-    typedef DirChecker::FileNames FileNames;
-    typedef DirChecker::DirNames  DirNames;
-    typedef QCMutex::Time         Time;
+    typedef DirChecker::LockFd         LockFd;
+    typedef DirChecker::FileNames      FileNames;
+    typedef DirChecker::DirNames       DirNames;
+    typedef DirChecker::DirInventories DirInventories;
+    typedef DirChecker::DirChangeTimes DirChangeTimes;
+    typedef QCMutex::Time              Time;
     enum {
         kTestIoBufferAlign = 4 << 10,
         kTestIoSize        = 8 * (4 << 10),
@@ -91,6 +99,10 @@ public:
           mIoTimeoutSec(-1),
           mLockFileName(),
           mFsIdPrefix(),
+          mInventoryFileName(),
+          mPendingInventories(),
+          mWrittenInventories(),
+          mInventoryFileSystemId(-1),
           mDirLocks(),
           mFileSystemId(-1),
           mRemoveFilesFlag(false),
@@ -126,6 +138,7 @@ public:
         FileNames       theIgnoreFileNames         = mIgnoreFileNames;
         string          theLockFileName;
         string          theFsIdPrefix;
+        string          theInventoryFileName;
         DirLocks        theDirLocks;
         mUpdateDirInfosFlag = false;
         int64_t         theLastCheckStartTime      = microseconds();
@@ -161,8 +174,13 @@ public:
             const int     theIoTimeoutSec                     = mIoTimeoutSec;
             const size_t  theMaxChunkFilesSampled             =
                 mMaxChunkFilesSampled;
-            theLockFileName = mLockFileName;
-            theFsIdPrefix   = mFsIdPrefix;
+            theLockFileName      = mLockFileName;
+            theFsIdPrefix        = mFsIdPrefix;
+            theInventoryFileName = mInventoryFileName;
+            const int64_t theInventoryFileSystemId = mInventoryFileSystemId;
+            DirInventories theInventories;
+            theInventories.swap(mPendingInventories);
+            DirChangeTimes theWrittenInventories;
             DirsAvailable theAvailableDirs;
             theDirLocks.swap(mDirLocks);
             QCASSERT(mDirLocks.empty());
@@ -188,6 +206,7 @@ public:
                         theRequireChunkHeaderChecksumFlag,
                         mChunkHeaderBuffer,
                         theFsIdPrefix,
+                        theInventoryFileName,
                         theFileSystemId,
                         theDeleteAllChaunksOnFsMismatchFlag,
                         theIoTimeoutSec,
@@ -197,8 +216,33 @@ public:
                         theAvailableDirs
                     );
                 }
+                if (! theInventoryFileName.empty()) {
+                    for (DirInventories::const_iterator
+                                theIt = theInventories.begin();
+                            theIt != theInventories.end();
+                            ++theIt) {
+                        int64_t theDirChangeTime = -1;
+                        if (WriteInventory(
+                                theIt->first,
+                                theInventoryFileName,
+                                theInventoryFileSystemId,
+                                theIt->second.first,
+                                theIt->second.second,
+                                &theDirChangeTime) == 0) {
+                            theWrittenInventories[theIt->first] =
+                                theDirChangeTime;
+                        }
+                    }
+                }
+                theInventories.clear();
                 theUnlocker.Lock();
             }
+            for (DirChangeTimes::const_iterator
+                        theIt = theWrittenInventories.begin();
+                    theIt != theWrittenInventories.end();
+                    ++theIt) {
+                mWrittenInventories[theIt->first] = theIt->second;
+            }
             bool theUpdateDirInfosFlag = false;
             for (DirsAvailable::iterator theIt = theAvailableDirs.begin();
                     theIt != theAvailableDirs.end();
@@ -426,6 +470,12 @@ public:
         QCStMutexLocker theLocker(mMutex);
         mFsIdPrefix = inFsIdPrefix;
     }
+    void SetInventoryFileName(
+        const string& inName)
+    {
+        QCStMutexLocker theLocker(mMutex);
+        mInventoryFileName = inName;
+    }
     void SetDeleteAllChaunksOnFsMismatch(
         int64_t inFsId,
         bool    inDeleteFlag)
@@ -456,6 +506,34 @@ public:
         QCStMutexLocker theLocker(mMutex);
         mCond.Notify();
     }
+    void ScheduleWriteInventories(
+        int64_t         inFileSystemId,
+        DirInventories& ioInventories)
+    {
+        QCStMutexLocker theLocker(mMutex);
+        mInventoryFileSystemId = inFileSystemId;
+        if (mPendingInventories.empty()) {
+            mPendingInventories.swap(ioInventories);
+        } else {
+            for (DirInventories::iterator theIt = ioInventories.begin();
+                    theIt != ioInventories.end();
+                    ++theIt) {
+                DirInventories::mapped_type& theInv =
+                    mPendingInventories[theIt->first];
+                theInv.first = theIt->second.first;
+                theInv.second.Swap(theIt->second.second);
+            }
+            ioInventories.clear();
+        }
+        mCond.Notify();
+    }
+    void GetWrittenInventories(
+        DirChangeTimes& outDirChangeTimes)
+    {
+        outDirChangeTimes.clear();
+        QCStMutexLocker theLocker(mMutex);
+        outDirChangeTimes.swap(mWrittenInventories);
+    }
 
 private:
     typedef std::map<dev_t, DeviceId> DeviceIds;
@@ -478,6 +556,10 @@ private:
     int               mIoTimeoutSec;
     string            mLockFileName;
     string            mFsIdPrefix;
+    string            mInventoryFileName;
+    DirInventories    mPendingInventories;
+    DirChangeTimes    mWrittenInventories;
+    int64_t           mInventoryFileSystemId;
     DirLocks          mDirLocks;
     int64_t           mFileSystemId;
     bool              mRemoveFilesFlag;
@@ -507,6 +589,7 @@ private:
         bool               inRequireChunkHeaderChecksumFlag,
         ChunkHeaderBuffer& inChunkHeaderBuffer,
         const string       inFsIdPrefix,
+        const string&      inInventoryFileName,
         int64_t            inFileSystemId,
         bool               inDeleteAllChaunksOnFsMismatchFlag,
         int                inIoTimeout,
@@ -620,6 +703,7 @@ private:
                     inRemoveFilesFlag,
                     inIgnoreErrorsFlag,
                     inFsIdPrefix,
+                    inInventoryFileName,
                     inChunkHeaderBuffer,
                     inIoTimeout,
                     inMaxChunkFilesSampled,
@@ -736,6 +820,7 @@ private:
         bool               inRemoveFilesFlag,
         bool               inIgnoreErrorsFlag,
         const string&      inFsIdPrefix,
+        const string&      inInventoryFileName,
         ChunkHeaderBuffer& inChunkHeaderBuffer,
         int                inIoTimeout,
         size_t             inMaxChunkFilesSampled,
@@ -747,6 +832,17 @@ private:
         QCASSERT(! inDirName.empty() && *(inDirName.rbegin()) == '/');
         outFileSystemId = -1;
         int theErr = 0;
+        const bool theInventoryFlag = ! inInventoryFileName.empty() &&
+            LoadInventory(
+                inDirName,
+                inInventoryFileName,
+                inFsIdPrefix,
+                outFileSystemId,
+                outFsIdPathName,
+                outChunkInfos);
+        // With inventory the directory is still read, in order to handle
+        // files not in the inventory the same way as the directory scan
+        // does, but stat is skipped for the files in the inventory.
         DIR* const theDirStream = opendir(inDirName.c_str());
         if (! theDirStream) {
             theErr = errno;
@@ -765,11 +861,32 @@ private:
         size_t               theGoodCnt          = 0;
         size_t               theReadCnt          = 0;
         size_t               theFrontIdx         = 0;
+        InventoryNames       theInventoryNames;
+        size_t               theInventoryNamesCnt     = 0;
+        bool                 theInventoryMismatchFlag = false;
         theName.reserve(1024);
+        if (theInventoryFlag) {
+            // Sample chunk headers the same way as with the directory scan,
+            // starting with the chunk with the largest id.
+            theGoodCnt = outChunkInfos.GetSize();
+            theInventoryNames.reserve(theGoodCnt);
+            for (size_t i = 0; i < theGoodCnt; i++) {
+                const ChunkInfo& theInfo = outChunkInfos[i];
+                if (theMaxChunkId < theInfo.mChunkId) {
+                    theMaxChunkId    = theInfo.mChunkId;
+                    theMaxChunkIndex = i;
+                }
+                theInventoryNames.push_back(make_pair(theInfo.mChunkId,
+                    make_pair(theInfo.mFileId, theInfo.mChunkVersion)));
+            }
+            theReadMaxChunkFlag = 0 < theGoodCnt;
+            sort(theInventoryNames.begin(), theInventoryNames.end());
+        }
         while ((theEntryPtr = readdir(theDirStream))) {
             if (strcmp(theEntryPtr->d_name, ".") == 0 ||
                     strcmp(theEntryPtr->d_name, "..") == 0 ||
-                    inLockName == theEntryPtr->d_name) {
+                    inLockName == theEntryPtr->d_name ||
+                    inInventoryFileName == theEntryPtr->d_name) {
                 continue;
             }
             theName = theEntryPtr->d_name;
@@ -808,6 +925,21 @@ private:
                     break;
                 }
             }
+            if (theInventoryFlag) {
+                kfsFileId_t  theFileId       = -1;
+                kfsChunkId_t theChunkId      = -1;
+                kfsSeq_t     theChunkVersion = -1;
+                if (ParseChunkFileName(theEntryPtr->d_name,
+                        theFileId, theChunkId, theChunkVersion) &&
+                        binary_search(
+                            theInventoryNames.begin(),
+                            theInventoryNames.end(),
+                            make_pair(theChunkId,
+                                make_pair(theFileId, theChunkVersion)))) {
+                    theInventoryNamesCnt++;
+                    continue;
+                }
+            }
             theName = inDirName;
             theName += theEntryPtr->d_name;
             struct stat  theBuf  = { 0 };
@@ -891,6 +1023,13 @@ private:
                 theErr = -ETIMEDOUT;
                 break;
             }
+            if (theInventoryFlag) {
+                KFS_LOG_STREAM_ERROR << theName <<
+                    " error: chunk file is not in the inventory" <<
+                KFS_LOG_EOM;
+                theInventoryMismatchFlag = true;
+                break;
+            }
             KFS_LOG_STREAM_DEBUG <<
                 "adding: "  << theName <<
                 " iotime: " << theIoTimeSec <<
@@ -914,12 +1053,17 @@ private:
             }
         }
         closedir(theDirStream);
-        if (theErr != 0) {
+        if (theErr != 0 && ! theInventoryFlag) {
             return theErr;
         }
+        theInventoryMismatchFlag = theInventoryMismatchFlag || (
+            theInventoryFlag &&
+            theInventoryNamesCnt != theInventoryNames.size()
+        );
+        const size_t theInventoryCnt = theGoodCnt;
         // Get fs id from the chunk with the largest id, which is likely the
         // most recently created chunk, and from randomly selected chunk files.
-        for (; ;) {
+        while (theErr == 0 && ! theInventoryMismatchFlag) {
             const size_t theCnt = min(inMaxChunkFilesSampled, theGoodCnt);
             size_t       theIdx;
             if (theReadMaxChunkFlag) {
@@ -1006,8 +1150,280 @@ private:
             Swap(theCur, outChunkInfos[theFrontIdx], theChunkInfo);
             theFrontIdx++;
         }
+        if (theInventoryFlag && (theErr != 0 || theInventoryMismatchFlag ||
+                theGoodCnt != theInventoryCnt)) {
+            KFS_LOG_STREAM_ERROR << inDirName << inInventoryFileName <<
+                " invalid inventory: sampled chunk files: " << theReadCnt <<
+                " invalid: "  << (theInventoryCnt - theGoodCnt) <<
+                " found: "    << theInventoryNamesCnt <<
+                " of: "       << theInventoryNames.size() <<
+                " mismatch: " << theInventoryMismatchFlag <<
+                " status: "   << theErr <<
+                " falling back to directory scan" <<
+            KFS_LOG_EOM;
+            outChunkInfos.Clear();
+            outFsIdPathName.clear();
+            return GetChunkFiles(
+                inDirName,
+                inLockName,
+                inIgnoreFileNames,
+                inRequireChunkHeaderChecksumFlag,
+                inRemoveFilesFlag,
+                inIgnoreErrorsFlag,
+                inFsIdPrefix,
+                string(),
+                inChunkHeaderBuffer,
+                inIoTimeout,
+                inMaxChunkFilesSampled,
+                inRandom,
+                outFileSystemId,
+                outFsIdPathName,
+                outChunkInfos
+            );
+        }
         return theErr;
     }
+    enum
+    {
+        kInventoryHeaderWords = 6,
+        kInventoryEntryWords  = 4
+    };
+    static const char* GetInventoryMagic()
+        { return "QFSCINV1"; }
+    static int64_t GetInventoryByteOrder()
+        { return int64_t(0x0102030405060708LL); }
+    static int64_t GetInventoryChecksum(
+        const int64_t* inPtr,
+        size_t         inCount)
+    {
+        return (int64_t)ComputeBlockChecksum(
+            reinterpret_cast<const char*>(inPtr), inCount * sizeof(*inPtr));
+    }
+    typedef vector<pair<kfsChunkId_t, pair<kfsFileId_t, kfsSeq_t> > >
+        InventoryNames;
+    static bool ParseChunkFileName(
+        const char*   inNamePtr,
+        kfsFileId_t&  outFileId,
+        kfsChunkId_t& outChunkId,
+        kfsSeq_t&     outChunkVersion)
+    {
+        const char*       thePtr    = inNamePtr;
+        const char* const theEndPtr = thePtr + strlen(thePtr);
+        return (
+            DecIntParser::Parse(thePtr, theEndPtr - thePtr, outFileId) &&
+            thePtr < theEndPtr && *thePtr++ == '.' &&
+            DecIntParser::Parse(thePtr, theEndPtr - thePtr, outChunkId) &&
+            thePtr < theEndPtr && *thePtr++ == '.' &&
+            DecIntParser::Parse(thePtr, theEndPtr - thePtr, outChunkVersion) &&
+            thePtr == theEndPtr &&
+            0 <= outFileId && 0 <= outChunkId && 0 <= outChunkVersion
+        );
+    }
+    // Load inventory, and invalidate it by truncating the inventory file,
+    // such that it can not be used after the directory gets modified.
+    static bool LoadInventory(
+        const string& inDirName,
+        const string& inFileName,
+        const string& inFsIdPrefix,
+        int64_t&      outFileSystemId,
+        string&       outFsIdPathName,
+        ChunkInfos&   outChunkInfos)
+    {
+        const string theName = inDirName + inFileName;
+        const int    theFd   = open(theName.c_str(), O_RDWR);
+        if (theFd < 0) {
+            const int theErr = errno;
+            if (theErr != ENOENT) {
+                KFS_LOG_STREAM_ERROR << theName <<
+                    ": " << QCUtils::SysError(theErr) <<
+                KFS_LOG_EOM;
+            }
+            return false;
+        }
+        struct stat theStat = {0};
+        if (fstat(theFd, &theStat) != 0 || theStat.st_size <= 0) {
+            close(theFd);
+            return false;
+        }
+        const int64_t theDirChangeTime = GetDirChangeTime(inDirName);
+        const size_t  theWordsCnt      = (size_t)(theStat.st_size / 8);
+        const char*   theMsgPtr        = 0;
+        vector<int64_t> theBuf;
+        if (theStat.st_size % 8 != 0 || theWordsCnt <
+                (size_t)kInventoryHeaderWords + 1) {
+            theMsgPtr = "invalid size";
+        } else {
+            theBuf.resize(theWordsCnt);
+            char*  thePtr = reinterpret_cast<char*>(&theBuf[0]);
+            size_t theRem = theWordsCnt * sizeof(theBuf[0]);
+            while (0 < theRem) {
+                const ssize_t theNRd = read(theFd, thePtr, theRem);
+                if (theNRd <= 0) {
+                    break;
+                }
+                thePtr += theNRd;
+                theRem -= theNRd;
+            }
+            if (0 < theRem) {
+                theMsgPtr = "read failure";
+            } else if (memcmp(&theBuf[0], GetInventoryMagic(), 8) != 0 ||
+                    theBuf[1] != GetInventoryByteOrder()) {
+                theMsgPtr = "invalid header";
+            } else if (theBuf[2] < 0 || (size_t)kInventoryHeaderWords + 1 +
+                    (size_t)theBuf[2] * kInventoryEntryWords != theWordsCnt) {
+                theMsgPtr = "invalid entry count";
+            } else if (GetInventoryChecksum(&theBuf[0], theWordsCnt - 1) !=
+                    theBuf[theWordsCnt - 1]) {
+                theMsgPtr = "checksum mismatch";
+            } else if (theDirChangeTime < 0 ||
+                    theBuf[4] != theDirChangeTime) {
+                theMsgPtr = "directory modified";
+            }
+        }
+        // Invalidate inventory. Truncate does not modify directory.
+        if (ftruncate(theFd, 0) != 0 || fsync(theFd) != 0) {
+            const int theErr = errno;
+            KFS_LOG_STREAM_ERROR << theName <<
+                ": truncate: " << QCUtils::SysError(theErr) <<
+            KFS_LOG_EOM;
+            if (! theMsgPtr) {
+                theMsgPtr = "failed to invalidate";
+            }
+        }
+        close(theFd);
+        if (theMsgPtr) {
+            KFS_LOG_STREAM_INFO << theName <<
+                ": ignoring inventory: " << theMsgPtr <<
+            KFS_LOG_EOM;
+            return false;
+        }
+        const int64_t  theCnt = theBuf[2];
+        const int64_t* thePtr = &theBuf[kInventoryHeaderWords];
+        outChunkInfos.Clear();
+        for (int64_t i = 0; i < theCnt; i++) {
+            ChunkInfo& theInfo = outChunkInfos.PushBack(ChunkInfo());
+            theInfo.mFileId       = (kfsFileId_t)*thePtr++;
+            theInfo.mChunkId      = (kfsChunkId_t)*thePtr++;
+            theInfo.mChunkVersion = (kfsSeq_t)*thePtr++;
+            theInfo.mChunkSize    = *thePtr++;
+        }
+        outFileSystemId = theBuf[3];
+        outFsIdPathName.clear();
+        if (0 < outFileSystemId && ! inFsIdPrefix.empty()) {
+            string theFsIdName = inDirName + inFsIdPrefix;
+            AppendDecIntToString(theFsIdName, outFileSystemId);
+            if (stat(theFsIdName.c_str(), &theStat) == 0) {
+                outFsIdPathName = theFsIdName;
+            }
+        }
+        KFS_LOG_STREAM_INFO << theName <<
+            ": loaded inventory: chunks: " << theCnt <<
+            " fs id: "                     << outFileSystemId <<
+        KFS_LOG_EOM;
+        return true;
+    }
+public:
+    static int64_t GetDirChangeTime(
+        const string& inDirName)
+    {
+        struct stat theStat = {0};
+        if (stat(inDirName.c_str(), &theStat) != 0) {
+            return -1;
+        }
+#if defined(KFS_OS_NAME_DARWIN)
+        return ((int64_t)theStat.st_mtimespec.tv_sec * 1000 * 1000 * 1000 +
+            theStat.st_mtimespec.tv_nsec);
+#elif defined(KFS_OS_NAME_LINUX)
+        return ((int64_t)theStat.st_mtim.tv_sec * 1000 * 1000 * 1000 +
+            theStat.st_mtim.tv_nsec);
+#else
+        return ((int64_t)theStat.st_mtime * 1000 * 1000 * 1000);
+#endif
+    }
+    static int WriteInventory(
+        const string&     inDirName,
+        const string&     inFileName,
+        int64_t           inFileSystemId,
+        int64_t           inDirChangeTime,
+        const ChunkInfos& inChunkInfos,
+        int64_t*          outDirChangeTimePtr)
+    {
+        const string theName = inDirName + inFileName;
+        if (inDirChangeTime < 0 ||
+                GetDirChangeTime(inDirName) != inDirChangeTime) {
+            KFS_LOG_STREAM_INFO << theName <<
+                ": not writing inventory: directory modified" <<
+            KFS_LOG_EOM;
+            return -EAGAIN;
+        }
+        // Creating inventory file modifies the directory, obtain the
+        // modification time after creating it.
+        const int theFd = open(theName.c_str(), O_WRONLY | O_CREAT | O_TRUNC,
+            0644);
+        if (theFd < 0) {
+            const int theErr = errno;
+            KFS_LOG_STREAM_ERROR << theName <<
+                ": " << QCUtils::SysError(theErr) <<
+            KFS_LOG_EOM;
+            return (theErr > 0 ? -theErr : -EIO);
+        }
+        const size_t    theCnt = inChunkInfos.GetSize();
+        vector<int64_t> theBuf;
+        theBuf.reserve(kInventoryHeaderWords + 1 +
+            theCnt * kInventoryEntryWords);
+        theBuf.resize(kInventoryHeaderWords, 0);
+        memcpy(&theBuf[0], GetInventoryMagic(), 8);
+        theBuf[1] = GetInventoryByteOrder();
+        theBuf[2] = (int64_t)theCnt;
+        theBuf[3] = inFileSystemId;
+        theBuf[4] = GetDirChangeTime(inDirName);
+        ChunkInfos::ConstIterator theIt(inChunkInfos);
+        const ChunkInfo*          thePtr;
+        while ((thePtr = theIt.Next())) {
+            theBuf.push_back((int64_t)thePtr->mFileId);
+            theBuf.push_back((int64_t)thePtr->mChunkId);
+            theBuf.push_back((int64_t)thePtr->mChunkVersion);
+            theBuf.push_back(thePtr->mChunkSize);
+        }
+        theBuf.push_back(GetInventoryChecksum(&theBuf[0], theBuf.size()));
+        const char* theWPtr = reinterpret_cast<const char*>(&theBuf[0]);
+        size_t      theRem  = theBuf.size() * sizeof(theBuf[0]);
+        int         theErr  = 0;
+        while (0 < theRem) {
+            const ssize_t theNWr = write(theFd, theWPtr, theRem);
+            if (theNWr <= 0) {
+                theErr = theNWr < 0 ? errno : EIO;
+                break;
+            }
+            theWPtr += theNWr;
+            theRem  -= theNWr;
+        }
+        if (theErr == 0 && 0 <= theBuf[4] && fsync(theFd) != 0) {
+            theErr = errno;
+        }
+        if (theErr != 0 || theBuf[4] < 0) {
+            KFS_LOG_STREAM_ERROR << theName <<
+                ": write inventory: " << QCUtils::SysError(theErr) <<
+            KFS_LOG_EOM;
+            if (ftruncate(theFd, 0) != 0) {
+                theErr = errno;
+            }
+            if (theErr == 0) {
+                theErr = EIO;
+            }
+        }
+        close(theFd);
+        if (theErr == 0) {
+            KFS_LOG_STREAM_INFO << theName <<
+                ": wrote inventory: chunks: " << theCnt <<
+            KFS_LOG_EOM;
+            if (outDirChangeTimePtr) {
+                *outDirChangeTimePtr = theBuf[4];
+            }
+        }
+        return (theErr > 0 ? -theErr : theErr);
+    }
+private:
     template<typename T>
     static void Swap(
         T& inLeft,
@@ -1446,10 +1862,52 @@ DirChecker::GetMaxChunkFilesSampled()
     return mImpl.GetMaxChunkFilesSampled();
 }
 
+    void
+DirChecker::SetInventoryFileName(
+    const string& inName)
+{
+    mImpl.SetInventoryFileName(inName);
+}
+
+    /* static */ int64_t
+DirChecker::GetDirChangeTime(
+    const string& inDirName)
+{
+    return Impl::GetDirChangeTime(inDirName);
+}
+
+    /* static */ int
+DirChecker::WriteInventory(
+    const string&     inDirName,
+    const string&     inFileName,
+    int64_t           inFileSystemId,
+    int64_t           inDirChangeTime,
+    const ChunkInfos& inChunkInfos,
+    int64_t*          outDirChangeTimePtr)
+{
+    return Impl::WriteInventory(inDirName, inFileName, inFileSystemId,
+        inDirChangeTime, inChunkInfos, outDirChangeTimePtr);
+}
+
     void
 DirChecker::Wakeup()
 {
     mImpl.Wakeup();
 }
 
+    void
+DirChecker::ScheduleWriteInventories(
+    int64_t                     inFileSystemId,
+    DirChecker::DirInventories& ioInventories)
+{
+    mImpl.ScheduleWriteInventories(inFileSystemId, ioInventories);
+}
+
+    void
+DirChecker::GetWrittenInventories(
+    DirChecker::DirChangeTimes& outDirChangeTimes)
+{
+    mImpl.GetWrittenInventories(outDirChangeTimes);
+}
+
 }
@@ -34,6 +34,7 @@
 #include <set>
 #include <string>
 #include <map>
+#include <utility>
 #include <inttypes.h>
 
 #include <boost/shared_ptr.hpp>
@@ -113,6 +114,11 @@ public:
         ChunkInfos mChunkInfos;
     };
     typedef map<string, DirInfo> DirsAvailable;
+    // Directory name to directory modification time and chunks map.
+    typedef map<string, pair<int64_t, ChunkInfos> > DirInventories;
+    // Directory name to directory modification time recorded in the
+    // successfully written inventory.
+    typedef map<string, int64_t> DirChangeTimes;
 
     DirChecker();
     ~DirChecker();
@@ -162,7 +168,31 @@ public:
     void SetMaxChunkFilesSampled(
         int inValue);
     int GetMaxChunkFilesSampled();
+    void SetInventoryFileName(
+        const string& inName);
     void Wakeup();
+    // Chunk directory inventory: the list of chunk files written on clean
+    // shutdown and periodically, and used on startup instead of stat of
+    // each chunk file if the directory has not been modified since the
+    // inventory was written.
+    // Write inventories by the dir checker thread. The argument is cleared.
+    void ScheduleWriteInventories(
+        int64_t         inFileSystemId,
+        DirInventories& ioInventories);
+    // Returns directory modification times of the inventories successfully
+    // written by the dir checker thread since the last invocation.
+    void GetWrittenInventories(
+        DirChangeTimes& outDirChangeTimes);
+    // Returns directory modification time, or -1 on error.
+    static int64_t GetDirChangeTime(
+        const string& inDirName);
+    static int WriteInventory(
+        const string&     inDirName,
+        const string&     inFileName,
+        int64_t           inFileSystemId,
+        int64_t           inDirChangeTime,
+        const ChunkInfos& inChunkInfos,
+        int64_t*          outDirChangeTimePtr = 0);
 private:
     class Impl;
     Impl& mImpl;
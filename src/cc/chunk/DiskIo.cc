@@ -33,6 +33,7 @@
 #include "common/Properties.h"
 #include "common/MsgLogger.h"
 #include "common/kfstypes.h"
+#include "common/time.h"
 
 #include "qcdio/QCDLList.h"
 #include "qcdio/QCMutex.h"
@@ -568,6 +569,8 @@ public:
             "chunkServer.diskQueue.maxBuffersPerRequest", 1 << 8)),
           mDiskQueueMaxEnqueueWaitNanoSec(inConfig.getValue(
             "chunkServer.diskQueue.maxEnqueueWaitTimeMilliSec", 0) * 1000000),
+          mDiskQueueLowPriorityWeight(inConfig.getValue(
+            "chunkServer.diskQueue.lowPriorityWeight", 0)),
           mBufferPoolPartitionCount(inConfig.getValue(
             "chunkServer.ioBufferPool.partitionCount", 1)),
           mBufferPoolPartitionBufferCount(inConfig.getValue(
@@ -577,6 +580,8 @@ public:
             "chunkServer.ioBufferPool.bufferSize", 4 << 10)),
           mBufferPoolLockMemoryFlag(inConfig.getValue(
             "chunkServer.ioBufferPool.lockMemory", false)),
+          mBufferPoolNumaNodeCount(inConfig.getValue(
+            "chunkServer.ioBufferPool.numaNodeCount", 0)),
           mDiskOverloadedPendingRequestCount(inConfig.getValue(
             "chunkServer.diskIo.overloadedPendingRequestCount",
                 mDiskQueueMaxQueueDepth * 3 / 4)),
@@ -656,7 +661,8 @@ public:
             mBufferPoolPartitionCount,
             mBufferPoolPartitionBufferCount,
             mBufferPoolBufferSize,
-            mBufferPoolLockMemoryFlag
+            mBufferPoolLockMemoryFlag,
+            mBufferPoolNumaNodeCount
         );
         if (theSysError) {
             if (inErrMessagePtr) {
@@ -979,6 +985,7 @@ public:
             }
             return false;
         }
+        theQueuePtr->SetLowPriorityWeight(mDiskQueueLowPriorityWeight);
         return true;
     }
     DiskQueue::Time GetMaxEnqueueWaitTimeNanoSec() const
@@ -1107,7 +1114,45 @@ public:
         { return mDiskQueueThreadCount; }
     void GetCounters(
         Counters& outCounters)
-        { outCounters = mCounters; }
+    {
+        outCounters = mCounters;
+        outCounters.mLowPriorityPendingCount = 0;
+        DiskQueueList::Iterator theIt(mDiskQueuesPtr);
+        DiskQueue*              thePtr;
+        while ((thePtr = theIt.Next())) {
+            outCounters.mLowPriorityPendingCount +=
+                thePtr->GetLowPriorityPendingCount();
+        }
+        outCounters.mBufferPoolRemoteNodeGetCount =
+            GetBufferPool().GetRemoteNodeGetCount();
+    }
+    void IoDone(
+        const DiskIo& inIo,
+        bool          inReadFlag)
+    {
+        if (inIo.mCachedFlag || inIo.mStartTime <= 0) {
+            return;
+        }
+        const int64_t theMicroSecs = microseconds() - inIo.mStartTime;
+        if (inReadFlag) {
+            mCounters.mReadMicroSecs += theMicroSecs;
+        } else {
+            mCounters.mWriteMicroSecs += theMicroSecs;
+        }
+        if (! inIo.mLowPriorityFlag) {
+            return;
+        }
+        const int64_t theByteCount = max(int64_t(0), inIo.mIoRetCode);
+        if (inReadFlag) {
+            mCounters.mLowPriorityReadCount++;
+            mCounters.mLowPriorityReadByteCount += theByteCount;
+            mCounters.mLowPriorityReadMicroSecs += theMicroSecs;
+        } else {
+            mCounters.mLowPriorityWriteCount++;
+            mCounters.mLowPriorityWriteByteCount += theByteCount;
+            mCounters.mLowPriorityWriteMicroSecs += theMicroSecs;
+        }
+    }
     void SetInFlight(
         DiskIo* inIoPtr)
     {
@@ -1115,6 +1160,7 @@ public:
             return;
         }
         inIoPtr->mEnqueueTime = Now();
+        inIoPtr->mStartTime   = microseconds();
         QCStMutexLocker theLocker(mMutex);
         AddInFlight(*inIoPtr);
     }
@@ -1164,11 +1210,15 @@ public:
         }
         mMaxIoTime = max(1, inProperties.getValue(
             "chunkServer.diskIo.maxIoTimeSec", mMaxIoTime));
+        mDiskQueueLowPriorityWeight = inProperties.getValue(
+            "chunkServer.diskQueue.lowPriorityWeight",
+            mDiskQueueLowPriorityWeight);
         mParameters = inProperties;
         DiskQueue* thePtr;
         DiskQueueList::Iterator theIt(mDiskQueuesPtr);
         while ((thePtr = theIt.Next())) {
             thePtr->SetParameters(mParameters);
+            thePtr->SetLowPriorityWeight(mDiskQueueLowPriorityWeight);
         }
     }
     int GetMaxIoTimeSec() const
@@ -1241,10 +1291,12 @@ private:
     const int                      mDiskQueueMaxQueueDepth;
     const int                      mDiskQueueMaxBuffersPerRequest;
     const DiskQueue::Time          mDiskQueueMaxEnqueueWaitNanoSec;
+    int                            mDiskQueueLowPriorityWeight;
     const int                      mBufferPoolPartitionCount;
     const int                      mBufferPoolPartitionBufferCount;
     const int                      mBufferPoolBufferSize;
     const int                      mBufferPoolLockMemoryFlag;
+    const int                      mBufferPoolNumaNodeCount;
     const int                      mDiskOverloadedPendingRequestCount;
     const int                      mDiskClearOverloadedPendingRequestCount;
     const int                      mDiskOverloadedMinFreeBufferCount;
@@ -2000,7 +2052,9 @@ DiskIo::DiskIo(
       mBlockIdx(0),
       mIoRetCode(0),
       mEnqueueTime(),
+      mStartTime(0),
       mWriteSyncFlag(false),
+      mLowPriorityFlag(false),
       mCachedFlag(false),
       mCompletionRequestId(QCDiskQueue::kRequestIdNone),
       mCompletionCode(QCDiskQueue::kErrorNone),
@@ -2153,7 +2207,8 @@ DiskIo::Read(
         0, // inBufferIteratorPtr // allocate buffers just beofre read
         theBufferCnt,
         this,
-        sDiskIoQueuesPtr->GetMaxEnqueueWaitTimeNanoSec()
+        sDiskIoQueuesPtr->GetMaxEnqueueWaitTimeNanoSec(),
+        mLowPriorityFlag
     );
     if (theStatus.IsGood()) {
         sDiskIoQueuesPtr->ReadPending(inNumBytes);
@@ -2519,7 +2574,8 @@ DiskIo::SubmitWrite(
         this,
         sDiskIoQueuesPtr->GetMaxEnqueueWaitTimeNanoSec(),
         inSyncFlag,
-        inEofHint
+        inEofHint,
+        mLowPriorityFlag
     );
     if (theStatus.IsGood()) {
         sDiskIoQueuesPtr->WritePending(inNumBytes);
@@ -2686,6 +2742,7 @@ DiskIo::RunCompletion()
     } else if (mReadLength > 0) {
         sDiskIoQueuesPtr->ReadPending(
             -int64_t(mReadLength), mIoRetCode, mCachedFlag);
+        sDiskIoQueuesPtr->IoDone(*this, true);
         theOpNamePtr = "read";
     } else if (! mIoBuffers.empty()) {
         sDiskIoQueuesPtr->WritePending(
@@ -2694,6 +2751,7 @@ DiskIo::RunCompletion()
             mIoRetCode,
             mCachedFlag
         );
+        sDiskIoQueuesPtr->IoDone(*this, false);
         theOpNamePtr = "write";
         if (mWriteSyncFlag) {
             sDiskIoQueuesPtr->SyncDone(mIoRetCode);
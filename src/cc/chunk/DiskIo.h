@@ -81,6 +81,16 @@ public:
         Counter mTimedOutErrorReadByteCount;
         Counter mTimedOutErrorWriteByteCount;
         Counter mOpenFilesCount;
+        Counter mReadMicroSecs;
+        Counter mWriteMicroSecs;
+        Counter mLowPriorityReadCount;
+        Counter mLowPriorityReadByteCount;
+        Counter mLowPriorityReadMicroSecs;
+        Counter mLowPriorityWriteCount;
+        Counter mLowPriorityWriteByteCount;
+        Counter mLowPriorityWriteMicroSecs;
+        Counter mLowPriorityPendingCount;
+        Counter mBufferPoolRemoteNodeGetCount;
         void Clear()
         {
             mReadCount                     = 0;
@@ -106,6 +116,16 @@ public:
             mTimedOutErrorReadByteCount    = 0;
             mTimedOutErrorWriteByteCount   = 0;
             mOpenFilesCount                = 0;
+            mReadMicroSecs                 = 0;
+            mWriteMicroSecs                = 0;
+            mLowPriorityReadCount          = 0;
+            mLowPriorityReadByteCount      = 0;
+            mLowPriorityReadMicroSecs      = 0;
+            mLowPriorityWriteCount         = 0;
+            mLowPriorityWriteByteCount     = 0;
+            mLowPriorityWriteMicroSecs     = 0;
+            mLowPriorityPendingCount       = 0;
+            mBufferPoolRemoteNodeGetCount  = 0;
         }
     };
     typedef int64_t Offset;
@@ -286,6 +306,11 @@ public:
 
     FilePtr GetFilePtr() const
         { return mFilePtr; }
+    /// Background io, replication and scrub, can be queued behind the
+    /// foreground io, see chunkServer.diskQueue.lowPriorityWeight.
+    void SetLowPriority(
+        bool inFlag)
+        { mLowPriorityFlag = inFlag; }
 private:
     /// Owning KfsCallbackObj.
     KfsCallbackObj* const  mCallbackObjPtr;
@@ -297,7 +322,9 @@ private:
     int64_t                mBlockIdx;
     int64_t                mIoRetCode;
     time_t                 mEnqueueTime;
+    int64_t                mStartTime;
     bool                   mWriteSyncFlag;
+    bool                   mLowPriorityFlag;
     bool                   mCachedFlag;
     QCDiskQueue::RequestId mCompletionRequestId;
     QCDiskQueue::Error     mCompletionCode;
@@ -39,6 +39,7 @@
 #include "utils.h"
 #include "MetaServerSM.h"
 #include "ClientManager.h"
+#include "ClientThread.h"
 
 #include "common/Version.h"
 #include "common/kfstypes.h"
@@ -639,6 +640,7 @@ MakeClientRequestHandler()
     .MakeParser<PingOp                  >("PING")
     .MakeParser<DumpChunkMapOp          >("DUMP_CHUNKMAP")
     .MakeParser<StatsOp                 >("STATS")
+    .DefDone()
     ;
 }
 
@@ -660,6 +662,7 @@ MakeMetaRequestHandler()
     .MakeParser<RetireOp                >("RETIRE")
     .MakeParser<SetProperties           >("CMD_SET_PROPERTIES")
     .MakeParser<RestartChunkServerOp    >("RESTART_CHUNK_SERVER")
+    .DefDone()
     ;
 }
 
@@ -1694,6 +1697,22 @@ HeartbeatOp::Execute()
         cm.mReadSkipDiskVerifyByteCount);
     HBAppend(os, "Read-chksum-skip-cs-bytes", "rsc",
         cm.mReadSkipDiskVerifyChecksumByteCount);
+    HBAppend(os, "Chunk-header-reads",        "hrd",
+        cm.mChunkHeaderReadCount);
+    HBAppend(os, "Chunk-header-cache-hits",   "hch",
+        cm.mChunkHeaderCacheHitCount);
+    HBAppend(os, "Scrub-chunks",              "scc",
+        cm.mScrubChunkCount);
+    HBAppend(os, "Scrub-bytes",               "scb",
+        cm.mScrubByteCount);
+    HBAppend(os, "Scrub-errors",              "sce",
+        cm.mScrubErrorCount);
+    HBAppend(os, "Scrub-deferred",            "scd",
+        cm.mScrubDeferCount);
+    HBAppend(os, "Write-block-cache-hits",    "wbh",
+        cm.mWriteBlockCacheHitCount);
+    HBAppend(os, "Write-block-reads",         "wbr",
+        cm.mWriteBlockCacheMissCount);
 
     MetaServerSM::Counters mc;
     gMetaServerSM.GetCounters(mc);
@@ -1711,6 +1730,17 @@ HeartbeatOp::Execute()
     HBAppend(os, 0, "cli", "");
     HBAppend(os, "Client-accept",  "accept", cli.mAcceptCount);
     HBAppend(os, "Client-active",  "cur",    cli.mClientCount);
+    if (0 < gClientManager.GetClientThreadCount()) {
+        string accepts;
+        for (int i = 0; i < gClientManager.GetClientThreadCount(); i++) {
+            if (0 < i) {
+                accepts += ',';
+            }
+            AppendDecIntToString(accepts,
+                gClientManager.GetClientThread(i)->GetAcceptCount());
+        }
+        HBAppend(os, "Client-thread-accept", "taccept", accepts);
+    }
     HBAppend(os, 0, "req: err", "");
     HBAppend(os, "Client-req-invalid",        "inval", cli.mBadRequestCount);
     HBAppend(os, "Client-req-invalid-header", "hdr",
@@ -1811,6 +1841,18 @@ HeartbeatOp::Execute()
     HBAppend(os, "WAppend-lost-chunks",   "csum", wa.mLostChunkCount);
     HBAppend(os, "WAppend-pending-bytes", "pbt",  wa.mPendingByteCount);
     HBAppend(os, "WAppend-low-buf-flush", "lobf", wa.mLowOnBuffersFlushCount);
+    HBAppend(os, 0, "batch", "");
+    HBAppend(os, "WAppend-batch-count",   "cnt",  wa.mAppendBatchCount);
+    HBAppend(os, "WAppend-batch-1-3",     "b1",
+        wa.mAppendBatchSizeHistogram[0]);
+    HBAppend(os, "WAppend-batch-4-15",    "b4",
+        wa.mAppendBatchSizeHistogram[1]);
+    HBAppend(os, "WAppend-batch-16-63",   "b16",
+        wa.mAppendBatchSizeHistogram[2]);
+    HBAppend(os, "WAppend-batch-64-255",  "b64",
+        wa.mAppendBatchSizeHistogram[3]);
+    HBAppend(os, "WAppend-batch-256-inf", "b256",
+        wa.mAppendBatchSizeHistogram[4]);
 
     const BufferManager&  bufMgr = DiskIo::GetBufferManager();
     HBAppend(os, 0, "buffers: bytes", "");
@@ -1863,10 +1905,30 @@ HeartbeatOp::Execute()
     HBAppend(os, "Disk-read-count", "cnt",   dio.mReadCount);
     HBAppend(os, "Disk-read-bytes", "bytes", dio.mReadByteCount);
     HBAppend(os, "Disk-read-errors","err",   dio.mReadErrorCount);
+    HBAppend(os, "Disk-read-micro-sec", "usec", dio.mReadMicroSecs);
     HBAppend(os, 0, "write", "");
     HBAppend(os, "Disk-write-count", "cnt",   dio.mWriteCount);
     HBAppend(os, "Disk-write-bytes", "bytes", dio.mWriteByteCount);
     HBAppend(os, "Disk-write-errors","err",   dio.mWriteErrorCount);
+    HBAppend(os, "Disk-write-micro-sec", "usec", dio.mWriteMicroSecs);
+    HBAppend(os, 0, "lowprio", "");
+    HBAppend(os, "Disk-low-prio-pending", "pend",
+        dio.mLowPriorityPendingCount);
+    HBAppend(os, "Disk-low-prio-read-count", "rcnt",
+        dio.mLowPriorityReadCount);
+    HBAppend(os, "Disk-low-prio-read-bytes", "rbytes",
+        dio.mLowPriorityReadByteCount);
+    HBAppend(os, "Disk-low-prio-read-micro-sec", "rusec",
+        dio.mLowPriorityReadMicroSecs);
+    HBAppend(os, "Disk-low-prio-write-count", "wcnt",
+        dio.mLowPriorityWriteCount);
+    HBAppend(os, "Disk-low-prio-write-bytes", "wbytes",
+        dio.mLowPriorityWriteByteCount);
+    HBAppend(os, "Disk-low-prio-write-micro-sec", "wusec",
+        dio.mLowPriorityWriteMicroSecs);
+    HBAppend(os, 0, "numa", "");
+    HBAppend(os, "Buffer-remote-node-count", "rnode",
+        dio.mBufferPoolRemoteNodeGetCount);
     HBAppend(os, 0, "sync", "");
     HBAppend(os, "Disk-sync-count", "cnt",   dio.mSyncCount);
     HBAppend(os, "Disk-sync-errors","err",   dio.mSyncErrorCount);
@@ -1929,6 +1991,8 @@ HeartbeatOp::Execute()
     HBAppend(os, "Recovery-count",  "cnt",    replCntrs.mRecoveryCount);
     HBAppend(os, "Recovery-errors", "err",    replCntrs.mRecoveryErrorCount);
     HBAppend(os, "Recovery-cancel", "cancel", replCntrs.mRecoveryCanceledCount);
+    HBAppend(os, "Recovery-net-bytes", "rcn", replCntrs.mRecoveryNetByteCount);
+    HBAppend(os, "Recovery-micro-sec", "rct", replCntrs.mRecoveryMicroSecs);
     HBAppend(os, "Replicator-reads",      "rrc",  replCntrs.mReadCount);
     HBAppend(os, "Replicator-read-bytes", "rrb",  replCntrs.mReadByteCount);
     HBAppend(os, "Replicator-writes",      "rwc", replCntrs.mWriteCount);
@@ -1948,6 +2012,14 @@ HeartbeatOp::Execute()
         globals().ctrDiskBytesRead.GetValue());
     HBAppend(os, "Disk-bytes-write", "dwr",
         globals().ctrDiskBytesWritten.GetValue());
+    HBAppend(os, "Ssl-handshakes",   "sslhs",
+        globals().ctrSslHandshakes.GetValue());
+    HBAppend(os, "Ssl-resumed",      "sslrs",
+        globals().ctrSslSessionsResumed.GetValue());
+    HBAppend(os, "Ssl-bytes-read",   "sslrd",
+        globals().ctrSslBytesRead.GetValue());
+    HBAppend(os, "Ssl-bytes-write",  "sslwr",
+        globals().ctrSslBytesWritten.GetValue());
     HBAppend(os, "Total-ops-count",  "ops",
         KfsOp::GetOpsCount());
     HBAppend(os, "Auth-clnt",  "authcl",
@@ -2099,7 +2171,14 @@ ReadOp::ParseResponse(const Properties& props, IOBuffer& iobuf)
 {
     const int checksumEntries = props.getValue("Checksum-entries", 0);
     checksum.clear();
-    if (0 < checksumEntries) {
+    const Properties::String* const hcks = 0 < checksumEntries ?
+        props.getValue("Checksums-hex") : 0;
+    if (hcks) {
+        if (! HexToChecksums(hcks->GetPtr(), hcks->GetSize(),
+                checksumEntries, checksum)) {
+            return false;
+        }
+    } else if (0 < checksumEntries) {
         const Properties::String* const cks = props.getValue("Checksums");
         if (! cks) {
             return false;
@@ -3136,6 +3215,16 @@ ReadOp::Response(ostream &os)
     }
     if (checksum.size() == 0) {
         os << "Checksums: " << 0 << "\r\n";
+    } else if (checksumHexFlag) {
+        os << "Checksums-hex: ";
+        const size_t kMaxCnt = 64;
+        char         buf[kMaxCnt * kChecksumHexWidth];
+        for (size_t i = 0; i < checksum.size(); i += kMaxCnt) {
+            const char* const end = ChecksumsToHex(&checksum[i],
+                min(kMaxCnt, checksum.size() - i), buf);
+            os.write(buf, end - buf);
+        }
+        os << "\r\n";
     } else {
         os << "Checksums: ";
         for (uint32_t i = 0; i < checksum.size(); i++)
@@ -3308,6 +3397,7 @@ ReadOp::Request(ostream& os)
     if (skipVerifyDiskChecksumFlag) {
         os << "Skip-Disk-Chksum: 1\r\n";
     }
+    os << "Checksums-hex: 1\r\n";
     if (requestChunkAccess) {
         os << "C-access: " << requestChunkAccess << "\r\n";
     }
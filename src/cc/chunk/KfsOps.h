@@ -1624,6 +1624,7 @@ struct ReadOp : public KfsClientChunkOp {
     int64_t          diskIOTime; /* how long did the AIOs take */
     int              retryCnt;
     bool             skipVerifyDiskChecksumFlag;
+    bool             checksumHexFlag; /* fixed width hex checksums requested */
     const char*      requestChunkAccess;
     /*
      * for writes that require the associated checksum block to be
@@ -1645,6 +1646,7 @@ struct ReadOp : public KfsClientChunkOp {
           diskIOTime(0),
           retryCnt(0),
           skipVerifyDiskChecksumFlag(false),
+          checksumHexFlag(false),
           requestChunkAccess(0),
           wop(0),
           scrubOp(0),
@@ -1661,6 +1663,7 @@ struct ReadOp : public KfsClientChunkOp {
           diskIOTime(0),
           retryCnt(0),
           skipVerifyDiskChecksumFlag(false),
+          checksumHexFlag(false),
           requestChunkAccess(0),
           wop(w),
           scrubOp(0),
@@ -1728,6 +1731,7 @@ struct ReadOp : public KfsClientChunkOp {
         .Def("Offset",           &ReadOp::offset)
         .Def("Num-bytes",        &ReadOp::numBytes)
         .Def("Skip-Disk-Chksum", &ReadOp::skipVerifyDiskChecksumFlag, false)
+        .Def("Checksums-hex",    &ReadOp::checksumHexFlag,            false)
         ;
     }
 };
@@ -49,6 +49,7 @@
 #include "common/MsgLogger.h"
 #include "common/StdAllocator.h"
 #include "common/IntToString.h"
+#include "common/time.h"
 
 #include "kfsio/KfsCallbackObj.h"
 #include "kfsio/NetConnection.h"
@@ -143,6 +144,7 @@ protected:
     bool                  mDone;
     bool                  mCancelFlag;
     DiskIo::FilePtr       mFileHandle;
+    int64_t const         mStartTime;
 
     // Handle the callback for a size request
     int HandleStartDone(int code, void* data);
@@ -268,7 +270,8 @@ ReplicatorImpl::ReplicatorImpl(ReplicateChunkOp *op, const RemoteSyncSMPtr &peer
     mWriteOp(op->chunkId, op->chunkVersion),
     mDone(false),
     mCancelFlag(false),
-    mFileHandle()
+    mFileHandle(),
+    mStartTime(microseconds())
 {
     mReadOp.chunkId = op->chunkId;
     mReadOp.chunkVersion = op->chunkVersion;
@@ -705,6 +708,9 @@ ReplicatorImpl::HandleReplicationDone(int code, void* data)
                 Ctrs().mRecoveryErrorCount++;
             }
         }
+    } else if (! mOwner->location.IsValid()) {
+        Ctrs().mRecoveryMicroSecs +=
+            max(int64_t(0), microseconds() - mStartTime);
     }
     mWriteOp.diskIo.reset();
     mWriteOp.dataBuf.Clear();
@@ -903,6 +909,7 @@ private:
     bool                 mReplicationDoneFlag;
     int64_t              mPrevReadCount;
     int64_t              mPrevReadByteCount;
+    int64_t              mPrevNetByteCount;
 
     RSReplicatorImpl(
         ReplicateChunkOp* op,
@@ -939,7 +946,8 @@ private:
           mPendingCancelFlag(false),
           mReplicationDoneFlag(false),
           mPrevReadCount(0),
-          mPrevReadByteCount(0)
+          mPrevReadByteCount(0),
+          mPrevNetByteCount(0)
     {
         if (mReadSize % IOBufferData::GetDefaultBufferSize() != 0) {
             FatalError("invalid read size");
@@ -1261,8 +1269,11 @@ private:
             stats.mReadCount - mPrevReadCount);
         Ctrs().mReadByteCount  += max(int64_t(0),
             stats.mReadByteCount - mPrevReadByteCount);
+        Ctrs().mRecoveryNetByteCount += max(int64_t(0),
+            csStats.mBytesReceivedCount - mPrevNetByteCount);
         mPrevReadCount     = stats.mReadCount;
         mPrevReadByteCount = stats.mReadByteCount;
+        mPrevNetByteCount  = csStats.mBytesReceivedCount;
         if (readOkFlag &&
                 sRSReaderMaxRecoverChunkSize < mOffset + pendingSize) {
             ostringstream os;
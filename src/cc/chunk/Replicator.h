@@ -55,6 +55,10 @@ public:
         Counter mWriteCount;
         Counter mReadByteCount;
         Counter mWriteByteCount;
+        // Striped chunk recovery network bytes received and run time. The
+        // recovered bytes are accounted in mReadByteCount.
+        Counter mRecoveryNetByteCount;
+        Counter mRecoveryMicroSecs;
         Counters()
             : mReplicationCount(0),
               mReplicationErrorCount(0),
@@ -66,7 +70,9 @@ public:
               mReadCount(0),
               mWriteCount(0),
               mReadByteCount(0),
-              mWriteByteCount(0)
+              mWriteByteCount(0),
+              mRecoveryNetByteCount(0),
+              mRecoveryMicroSecs(0)
             {}
         void Reset()
             { *this = Counters(); }
@@ -28,6 +28,7 @@
 #define REQUEST_PARSER_H
 
 #include <map>
+#include <vector>
 #include <utility>
 #include <string>
 #include <algorithm>
@@ -49,6 +50,7 @@ using std::ostream;
 using std::min;
 using std::make_pair;
 using std::map;
+using std::vector;
 using std::less;
 
 // Multiple inheritance below used only to enforce construction order.
@@ -517,6 +519,92 @@ private:
     const bool        mIgnoreMalformedFlag;
 };
 
+// Read only open addressing hash table, built from the std::map once the
+// definition is complete. Used for request name and header name lookups, in
+// order to avoid red black tree traversal with memcmp() at every level for
+// every request header line parsed.
+template <typename T>
+class TokenLookupTable
+{
+public:
+    typedef PropertiesTokenizer::Token Key;
+
+    TokenLookupTable()
+        : mSlots(),
+          mMask(0)
+        {}
+    template<typename MT>
+    void Build(
+        const MT& inMap)
+    {
+        size_t theSize = 8;
+        while (theSize < inMap.size() * 2) {
+            theSize <<= 1;
+        }
+        mMask = theSize - 1;
+        mSlots.assign(theSize, Slot());
+        for (typename MT::const_iterator theIt = inMap.begin();
+                theIt != inMap.end();
+                ++theIt) {
+            size_t theIdx = Hash(theIt->first) & mMask;
+            while (mSlots[theIdx].mUsedFlag) {
+                theIdx = (theIdx + 1) & mMask;
+            }
+            Slot& theSlot = mSlots[theIdx];
+            theSlot.mKey      = theIt->first;
+            theSlot.mValue    = theIt->second;
+            theSlot.mUsedFlag = true;
+        }
+    }
+    const T* Find(
+        const Key& inKey) const
+    {
+        if (mSlots.empty()) {
+            return 0;
+        }
+        size_t theIdx = Hash(inKey) & mMask;
+        for (; ;) {
+            const Slot& theSlot = mSlots[theIdx];
+            if (! theSlot.mUsedFlag) {
+                return 0;
+            }
+            if (theSlot.mKey == inKey) {
+                return &theSlot.mValue;
+            }
+            theIdx = (theIdx + 1) & mMask;
+        }
+    }
+private:
+    struct Slot
+    {
+        Slot()
+            : mKey(),
+              mValue(),
+              mUsedFlag(false)
+            {}
+        Key  mKey;
+        T    mValue;
+        bool mUsedFlag;
+    };
+    typedef vector<Slot> Slots;
+
+    Slots  mSlots;
+    size_t mMask;
+
+    static size_t Hash(
+        const Key& inKey)
+    {
+        const unsigned char*       thePtr    =
+            reinterpret_cast<const unsigned char*>(inKey.mPtr);
+        const unsigned char* const theEndPtr = thePtr + inKey.mLen;
+        size_t                     theHash   = inKey.mLen;
+        while (thePtr < theEndPtr) {
+            theHash = theHash * 31 + *thePtr++;
+        }
+        return (theHash ^ (theHash >> 7));
+    }
+};
+
 // Create parser for object fields, and invoke appropriate parsers based on the
 // request header names.
 template <typename OBJ, typename VALUE_PARSER=ValueParser>
@@ -532,7 +620,8 @@ public:
 
     ObjectParser()
         : mDefDoneFlag(false),
-          mFields()
+          mFields(),
+          mFieldTable()
         {}
     virtual ~ObjectParser()
     {
@@ -559,6 +648,9 @@ public:
     }
     ObjectParser& DefDone()
     {
+        if (! mDefDoneFlag) {
+            mFieldTable.Build(mFields);
+        }
         mDefDoneFlag = true;
         return *this;
     }
@@ -569,17 +661,17 @@ public:
         OBJ*       inObjPtr) const
     {
         while (inTokenizer.Next()) {
-            const Token& theKey = inTokenizer.GetKey();
-            typename Fields::const_iterator const theIt = mFields.find(theKey);
-            if (theIt == mFields.end()) {
+            const Token&                theKey   = inTokenizer.GetKey();
+            const AbstractField* const* theField = mFieldTable.Find(theKey);
+            if (theField) {
+                (*theField)->Set(inObjPtr, inTokenizer.GetValue());
+            } else {
                 const Token& theValue = inTokenizer.GetValue();
                 if (! inObjPtr->HandleUnknownField(
                         theKey.mPtr,    theKey.mLen,
                         theValue.mPtr, theValue.mLen)) {
                     break;
                 }
-            } else {
-                theIt->second->Set(inObjPtr, inTokenizer.GetValue());
             }
         }
     }
@@ -635,10 +727,12 @@ private:
         T const       mDefault;
     };
 
-    typedef map<Key, AbstractField*, less<Key> > Fields;
+    typedef map<Key, AbstractField*, less<Key> >   Fields;
+    typedef TokenLookupTable<const AbstractField*> FieldTable;
 
-    bool   mDefDoneFlag;
-    Fields mFields;
+    bool       mDefDoneFlag;
+    Fields     mFields;
+    FieldTable mFieldTable;
 };
 
 template <typename ABSTRACT_OBJ>
@@ -730,6 +824,8 @@ public:
     typedef typename Parser::Checksum           Checksum;
 
     RequestHandler()
+        : mParsers(),
+          mParserTable()
         {}
     ~RequestHandler()
         {}
@@ -749,10 +845,10 @@ public:
         while (thePtr < theEndPtr && ! IsWSpace(*thePtr)) {
             thePtr++;
         }
-        const size_t theNameLen = thePtr - theNamePtr;
-        typename Parsers::const_iterator const theIt =
-            mParsers.find(Name(theNamePtr, theNameLen));
-        if (theIt == mParsers.end()) {
+        const size_t         theNameLen = thePtr - theNamePtr;
+        const Parser* const* theParser  =
+            mParserTable.Find(Name(theNamePtr, theNameLen));
+        if (! theParser) {
             return 0;
         }
         // Get optional header checksum.
@@ -767,7 +863,7 @@ public:
         while (thePtr < theEndPtr && IsWSpace(*thePtr)) {
             thePtr++;
         }
-        return theIt->second->Parse(
+        return (*theParser)->Parse(
             thePtr,
             theEndPtr - thePtr,
             theNamePtr,
@@ -795,6 +891,13 @@ public:
         }
         return *this;
     }
+    // Must be invoked after the last parser is added, in order to build the
+    // request name lookup table.
+    RequestHandler& DefDone()
+    {
+        mParserTable.Build(mParsers);
+        return *this;
+    }
     template <typename OBJ>
     RequestHandler& MakeParser(
         const char* inNamePtr,
@@ -810,10 +913,12 @@ public:
     }
 
 private:
-    typedef PropertiesTokenizer::Token Name;
-    typedef map<Name, const Parser*>   Parsers;
+    typedef PropertiesTokenizer::Token      Name;
+    typedef map<Name, const Parser*>        Parsers;
+    typedef TokenLookupTable<const Parser*> ParserTable;
 
-    Parsers mParsers;
+    Parsers     mParsers;
+    ParserTable mParserTable;
 };
 
 }
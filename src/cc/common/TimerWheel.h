@@ -58,10 +58,13 @@ public:
     {
         // Round to the next slot to ensure the expiration time will be less
         // than the current time at the moment of the the slot traversal.
-        size_t theIdx = inExpires < mNextRunTime ?
+        // The slot with index i > 0 is traversed by Run() when the current
+        // time is greater or equal to mNextRunTime + (i - 1) * resolution,
+        // and the slot 0 on the next Run() invocation.
+        size_t theIdx = inExpires + (TimeT)TimerResolutionT <= mNextRunTime ?
             size_t(0) :
-            ((size_t)(inExpires - mNextRunTime) + TimerResolutionT) /
-                TimerResolutionT;
+            1 + (size_t)(inExpires + (TimeT)(TimerResolutionT - 1) -
+                mNextRunTime) / TimerResolutionT;
         if (BucketCntT <= theIdx) {
             // Max timeout.
             theIdx = (mCurBucket == 0 ? BucketCntT : mCurBucket) - 1;
@@ -108,14 +111,39 @@ public:
     void SetNextRunTime(
         TimeT& inNextRunTime)
         { mNextRunTime = inNextRunTime; }
+    // Returns the time when Run() needs to be invoked next in order to
+    // process the first non empty slot, or inMaxTime if there are no
+    // entries scheduled before inMaxTime.
+    TimeT GetNextRunTime(
+        TimeT inNow,
+        TimeT inMaxTime) const
+    {
+        if (ListT::IsInList(mBuckets[mCurBucket])) {
+            return inNow;
+        }
+        for (size_t i = 1, k = mCurBucket; i < BucketCntT; i++) {
+            const TimeT theTime =
+                mNextRunTime + (TimeT)((i - 1) * TimerResolutionT);
+            if (inMaxTime <= theTime) {
+                break;
+            }
+            if (BucketCntT <= ++k) {
+                k = 0;
+            }
+            if (ListT::IsInList(mBuckets[k])) {
+                return theTime;
+            }
+        }
+        return inMaxTime;
+    }
     template<typename FT>
     void Apply(
         FT& inFunctor) const
-        { ApplySelf(inFunctor, &mTmpList); }
+        { ApplySelf(inFunctor, mBuckets, mCurBucket); }
     template<typename FT>
     void Apply(
         FT& inFunctor)
-        { ApplySelf(inFunctor, &mTmpList); }
+        { ApplySelf(inFunctor, mBuckets, mCurBucket); }
 private:
     size_t mCurBucket;
     TimeT  mNextRunTime;
@@ -123,12 +151,13 @@ private:
     T      mBuckets[BucketCntT];
 
     template<typename FT, typename ET>
-    void ApplySelf(
-        FT& inFunctor,
-        ET* /* inConstQualifiedElementTypePtr */) const
+    static void ApplySelf(
+        FT&    inFunctor,
+        ET*    inBucketsPtr,
+        size_t inCurBucket)
     {
-        for (size_t i = 0, k = mCurBucket; i < BucketCntT; i++) {
-            ET& theList = mBuckets[k];
+        for (size_t i = 0, k = inCurBucket; i < BucketCntT; i++) {
+            ET& theList = inBucketsPtr[k];
             ET* thePtr  = &theList;
             while (&theList != (thePtr = ListT::GetNextPtr(thePtr))) {
                 inFunctor(*thePtr);
@@ -0,0 +1,185 @@
+//---------------------------------------------------------- -*- Mode: C++ -*-
+// $Id$
+//
+// Copyright 2026 Quantcast Corporation. All rights reserved.
+//
+// This file is part of Kosmos File System (KFS).
+//
+// Licensed under the Apache License, Version 2.0
+// (the "License"); you may not use this file except in compliance with
+// the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+//
+// \file WeightTree.h
+// \brief Binary indexed (Fenwick) tree of non negative item weights.
+//
+// Allows to pick an item with the probability proportional to its weight,
+// and to change item weight in O(log(n)).
+//
+//----------------------------------------------------------------------------
+
+#ifndef WEIGHT_TREE_H
+#define WEIGHT_TREE_H
+
+#include "common/StdAllocator.h"
+
+#include <vector>
+
+#include <stddef.h>
+#include <inttypes.h>
+#include <assert.h>
+
+namespace KFS
+{
+using std::vector;
+
+class WeightTree
+{
+public:
+    typedef int64_t Weight;
+
+    WeightTree()
+        : mTree(),
+          mWeights(),
+          mSum(0)
+        {}
+    // Build the tree from the first elements of the items pairs in O(n).
+    template<typename T>
+    void Build(
+        const T& inItems)
+    {
+        const size_t theSize = inItems.size();
+        mWeights.resize(theSize);
+        for (size_t i = 0; i < theSize; i++) {
+            assert(0 <= inItems[i].first);
+            mWeights[i] = inItems[i].first;
+        }
+        Rebuild();
+    }
+    // Set the number of items, all items weights are set to 0.
+    void Resize(
+        size_t inSize)
+    {
+        mWeights.assign(inSize, Weight(0));
+        mTree.assign(inSize + 1, Weight(0));
+        mSum = 0;
+    }
+    void SetWeight(
+        size_t inIdx,
+        Weight inWeight)
+    {
+        assert(inIdx < mWeights.size() && 0 <= inWeight);
+        const Weight theDelta = inWeight - mWeights[inIdx];
+        if (theDelta == 0) {
+            return;
+        }
+        mWeights[inIdx] = inWeight;
+        mSum += theDelta;
+        const size_t theSize = mWeights.size();
+        for (size_t i = inIdx + 1; i <= theSize; i += i & (0 - i)) {
+            mTree[i] += theDelta;
+        }
+    }
+    Weight GetWeight(
+        size_t inIdx) const
+        { return mWeights[inIdx]; }
+    // Returns the sum of the weights of the items with index less than
+    // inIdx.
+    Weight GetPrefixSum(
+        size_t inIdx) const
+    {
+        assert(inIdx <= mWeights.size());
+        Weight theSum = 0;
+        for (size_t i = inIdx; 0 < i; i -= i & (0 - i)) {
+            theSum += mTree[i];
+        }
+        return theSum;
+    }
+    Weight GetSum() const
+        { return mSum; }
+    size_t GetSize() const
+        { return mWeights.size(); }
+    bool IsEmpty() const
+        { return mWeights.empty(); }
+    // Returns the smallest index with weights prefix sum greater than
+    // inValue, or the number of items if inValue is greater or equal to the
+    // sum of all weights.
+    size_t Find(
+        Weight inValue) const
+    {
+        const size_t theSize = mWeights.size();
+        size_t       theStep = 1;
+        while (theStep <= theSize / 2) {
+            theStep += theStep;
+        }
+        Weight theValue = inValue;
+        size_t theIdx   = 0;
+        for ( ; 0 < theStep; theStep >>= 1) {
+            const size_t k = theIdx + theStep;
+            if (k <= theSize && mTree[k] <= theValue) {
+                theIdx    = k;
+                theValue -= mTree[k];
+            }
+        }
+        return theIdx;
+    }
+    // Same as the above, but treats the items with the indices in the
+    // ascending ordered [inExcludedStart, inExcludedEnd) range as if their
+    // weight were 0. The excluded items are not removed from the tree, in
+    // order to allow to share the tree between multiple readers. The cost is
+    // O(log(n)) per excluded item.
+    template<typename IT>
+    size_t Find(
+        Weight inValue,
+        IT     inExcludedStart,
+        IT     inExcludedEnd) const
+    {
+        Weight theValue = inValue;
+        for (IT theIt = inExcludedStart; theIt != inExcludedEnd; ++theIt) {
+            if (theValue < GetPrefixSum(*theIt)) {
+                break;
+            }
+            theValue += mWeights[*theIt];
+        }
+        return Find(theValue);
+    }
+    void Clear()
+    {
+        mTree.clear();
+        mWeights.clear();
+        mSum = 0;
+    }
+private:
+    typedef vector<Weight, StdAllocator<Weight> > Weights;
+
+    Weights mTree;
+    Weights mWeights;
+    Weight  mSum;
+
+    void Rebuild()
+    {
+        const size_t theSize = mWeights.size();
+        mTree.assign(theSize + 1, Weight(0));
+        mSum = 0;
+        for (size_t i = 1; i <= theSize; i++) {
+            mSum     += mWeights[i - 1];
+            mTree[i] += mWeights[i - 1];
+            const size_t k = i + (i & (0 - i));
+            if (k <= theSize) {
+                mTree[k] += mTree[i];
+            }
+        }
+    }
+};
+
+} // namespace KFS
+
+#endif /* WEIGHT_TREE_H */
@@ -25,9 +25,11 @@
 
 #include "common/RequestParser.h"
 #include "common/Properties.h"
+#include "common/time.h"
 
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 using namespace KFS;
@@ -186,6 +188,79 @@ public:
     }
 };
 
+// Other request "shapes" used for the benchmark mix.
+class LookupTest : public AbstractTest, public AbstractTest1
+{
+public:
+    int64_t         parentFid;
+    StringBufT<256> name;
+
+    LookupTest()
+        : AbstractTest(),
+          AbstractTest1(),
+          parentFid(-1),
+          name()
+        {}
+    virtual ~LookupTest()
+        {}
+    template<typename T> static T& ParserDef(
+        T& inParser)
+    {
+       return
+            AbstractTest1::ParserDef(
+            AbstractTest::ParserDef(
+                inParser
+            ))
+            .Def("Parent File-handle", &LookupTest::parentFid, int64_t(-1))
+            .Def("Filename",           &LookupTest::name                  )
+        ;
+    }
+};
+
+class ChunkIoTest : public AbstractTest
+{
+public:
+    int64_t fid;
+    int64_t chunkId;
+    int64_t chunkVersion;
+    int64_t offset;
+    int     numBytes;
+    int64_t writeId;
+    int64_t checksum;
+    bool    replyFlag;
+
+    ChunkIoTest()
+        : AbstractTest(),
+          fid(-1),
+          chunkId(-1),
+          chunkVersion(-1),
+          offset(-1),
+          numBytes(0),
+          writeId(-1),
+          checksum(-1),
+          replyFlag(false)
+        {}
+    virtual ~ChunkIoTest()
+        {}
+    template<typename T> static T& ParserDef(
+        T& inParser)
+    {
+       return
+            AbstractTest::ParserDef(
+                inParser
+            )
+            .Def("File-handle",   &ChunkIoTest::fid,          int64_t(-1))
+            .Def("Chunk-handle",  &ChunkIoTest::chunkId,      int64_t(-1))
+            .Def("Chunk-version", &ChunkIoTest::chunkVersion, int64_t(-1))
+            .Def("Offset",        &ChunkIoTest::offset,       int64_t(-1))
+            .Def("Num-bytes",     &ChunkIoTest::numBytes,     0          )
+            .Def("Write-id",      &ChunkIoTest::writeId,      int64_t(-1))
+            .Def("Checksum",      &ChunkIoTest::checksum,     int64_t(-1))
+            .Def("Reply",         &ChunkIoTest::replyFlag,    false      )
+        ;
+    }
+};
+
 /*
 ALLOCATE\r
 Cseq: $seq\r
@@ -211,16 +286,235 @@ static const ReqHandler& MakeRequestHandler()
     return sHandler
         .MakeParser<Test>("ALLOCATE")
         .MakeParser<Test>("xALLOCATE")
+        .MakeParser<LookupTest>("LOOKUP")
+        .MakeParser<LookupTest>("LOOKUP_PATH")
+        .MakeParser<LookupTest>("CREATE")
+        .MakeParser<LookupTest>("MKDIR")
+        .MakeParser<LookupTest>("REMOVE")
+        .MakeParser<LookupTest>("RMDIR")
+        .MakeParser<LookupTest>("RENAME")
+        .MakeParser<ChunkIoTest>("READDIR")
+        .MakeParser<ChunkIoTest>("READDIRPLUS")
+        .MakeParser<ChunkIoTest>("GETALLOC")
+        .MakeParser<ChunkIoTest>("GETLAYOUT")
+        .MakeParser<ChunkIoTest>("TRUNCATE")
+        .MakeParser<ChunkIoTest>("LEASE_ACQUIRE")
+        .MakeParser<ChunkIoTest>("LEASE_RENEW")
+        .MakeParser<ChunkIoTest>("PING")
+        .MakeParser<ChunkIoTest>("STATS")
+        .DefDone()
     ;
 }
 static const ReqHandler& sReqHandler = MakeRequestHandler();
 
+// Chunk server and client use hex integer representation with short rpc
+// format.
+typedef RequestHandler<AbstractTest, ValueParserT<HexIntParser> >
+    HexReqHandler;
+static const HexReqHandler& MakeHexRequestHandler()
+{
+    static HexReqHandler sHandler;
+    return sHandler
+        .MakeParser<Test>("ALLOCATE")
+        .MakeParser<Test>("xALLOCATE")
+        .MakeParser<ChunkIoTest>("SIZE")
+        .MakeParser<ChunkIoTest>("CLOSE")
+        .MakeParser<ChunkIoTest>("READ")
+        .MakeParser<ChunkIoTest>("WRITE_ID_ALLOC")
+        .MakeParser<ChunkIoTest>("WRITE_PREPARE")
+        .MakeParser<ChunkIoTest>("WRITE_SYNC")
+        .MakeParser<ChunkIoTest>("RECORD_APPEND")
+        .MakeParser<ChunkIoTest>("GET_CHUNK_METADATA")
+        .MakeParser<ChunkIoTest>("DELETE")
+        .MakeParser<ChunkIoTest>("HEARTBEAT")
+        .MakeParser<ChunkIoTest>("PING")
+        .DefDone()
+    ;
+}
+static const HexReqHandler& sHexReqHandler = MakeHexRequestHandler();
+
+template<typename T>
+static int
+Benchmark(
+    const char*        name,
+    const T&           handler,
+    const char* const* reqs,
+    int                reqCount,
+    int64_t            count)
+{
+    size_t lens[32];
+    if ((int)(sizeof(lens) / sizeof(lens[0])) < reqCount) {
+        return 1;
+    }
+    for (int i = 0; i < reqCount; i++) {
+        lens[i] = strlen(reqs[i]);
+    }
+    const int64_t start = microseconds();
+    int64_t       seq   = 0;
+    for (int64_t i = 0; i < count; i++) {
+        const int           idx = (int)(i % reqCount);
+        AbstractTest* const tst = handler.Handle(reqs[idx], lens[idx]);
+        if (! tst) {
+            std::cout << "parse failure\nRequest:\n" << reqs[idx];
+            return 1;
+        }
+        seq += tst->seq;
+        delete tst;
+    }
+    const int64_t elapsed = std::max(int64_t(1), microseconds() - start);
+    std::cout << name <<
+        ": requests: "  << count <<
+        " types: "      << reqCount <<
+        " time: "       << elapsed * 1e-6 << " sec." <<
+        " requests/sec: " << count * 1e6 / elapsed <<
+        " sum: "        << seq <<
+    "\n";
+    return 0;
+}
+
+static int
+Benchmark(
+    int64_t count)
+{
+    const char* const decReq =
+        "ALLOCATE\r\n"
+        "Cseq: 1234567\r\n"
+        "Version: KFS/1.0\r\n"
+        "Client-Protocol-Version: 114\r\n"
+        "Client-host: somehostname\r\n"
+        "Pathname: /sort/job/1/fanout/27/file.27\r\n"
+        "File-handle: 20397611\r\n"
+        "Chunk-offset: 134217728\r\n"
+        "Chunk-append: 1\r\n"
+        "Space-reserve: 0\r\n"
+        "Max-appenders: 640000000\r\n"
+        "\r\n";
+    const char* const hexReq =
+        "ALLOCATE\r\n"
+        "Cseq: 12D687\r\n"
+        "Version: KFS/1.0\r\n"
+        "Client-Protocol-Version: 72\r\n"
+        "Client-host: somehostname\r\n"
+        "Pathname: /sort/job/1/fanout/27/file.27\r\n"
+        "File-handle: 1373F2B\r\n"
+        "Chunk-offset: 8000000\r\n"
+        "Chunk-append: 1\r\n"
+        "Space-reserve: 0\r\n"
+        "Max-appenders: 2625A000\r\n"
+        "\r\n";
+    // Mix of the most frequent requests with the different number of fields.
+    const char* const decReqs[] = {
+        decReq,
+        "LOOKUP\r\n"
+        "Cseq: 1234568\r\n"
+        "Version: KFS/1.0\r\n"
+        "Client-Protocol-Version: 114\r\n"
+        "Parent File-handle: 20397610\r\n"
+        "Filename: file.27\r\n"
+        "\r\n",
+        "GETLAYOUT\r\n"
+        "Cseq: 1234569\r\n"
+        "Version: KFS/1.0\r\n"
+        "File-handle: 20397611\r\n"
+        "\r\n",
+        "GETALLOC\r\n"
+        "Cseq: 1234570\r\n"
+        "Version: KFS/1.0\r\n"
+        "File-handle: 20397611\r\n"
+        "Offset: 134217728\r\n"
+        "\r\n",
+        "LEASE_RENEW\r\n"
+        "Cseq: 1234571\r\n"
+        "Version: KFS/1.0\r\n"
+        "Chunk-handle: 1873459\r\n"
+        "\r\n",
+        "PING\r\n"
+        "Cseq: 1234572\r\n"
+        "Version: KFS/1.0\r\n"
+        "\r\n"
+    };
+    const char* const hexReqs[] = {
+        hexReq,
+        "READ\r\n"
+        "Cseq: 12D688\r\n"
+        "Version: KFS/1.0\r\n"
+        "Chunk-handle: 1C9633\r\n"
+        "Chunk-version: 3\r\n"
+        "Offset: 100000\r\n"
+        "Num-bytes: 100000\r\n"
+        "\r\n",
+        "WRITE_PREPARE\r\n"
+        "Cseq: 12D689\r\n"
+        "Version: KFS/1.0\r\n"
+        "Chunk-handle: 1C9633\r\n"
+        "Chunk-version: 3\r\n"
+        "Offset: 100000\r\n"
+        "Num-bytes: 10000\r\n"
+        "Checksum: 9A3E21F7\r\n"
+        "Reply: 1\r\n"
+        "\r\n",
+        "WRITE_SYNC\r\n"
+        "Cseq: 12D68A\r\n"
+        "Version: KFS/1.0\r\n"
+        "Chunk-handle: 1C9633\r\n"
+        "Chunk-version: 3\r\n"
+        "Offset: 100000\r\n"
+        "Num-bytes: 10000\r\n"
+        "Write-id: 7F3A2\r\n"
+        "\r\n",
+        "GET_CHUNK_METADATA\r\n"
+        "Cseq: 12D68B\r\n"
+        "Version: KFS/1.0\r\n"
+        "Chunk-handle: 1C9633\r\n"
+        "\r\n"
+    };
+    int ret = Benchmark("decimal (meta server) allocate",
+        sReqHandler, &decReq, 1, count);
+    if (ret == 0) {
+        ret = Benchmark("decimal (meta server) mix", sReqHandler,
+            decReqs, (int)(sizeof(decReqs) / sizeof(decReqs[0])), count);
+    }
+    if (ret == 0) {
+        ret = Benchmark("hex (chunk server) allocate",
+            sHexReqHandler, &hexReq, 1, count);
+    }
+    if (ret == 0) {
+        ret = Benchmark("hex (chunk server) mix", sHexReqHandler,
+            hexReqs, (int)(sizeof(hexReqs) / sizeof(hexReqs[0])), count);
+    }
+    if (ret == 0) {
+        BufferInputStream is;
+        const int64_t     start = microseconds();
+        for (int64_t i = 0; i < count; i++) {
+            delete Test::Load(is.Set(decReq, strlen(decReq)));
+        }
+        const int64_t elapsed = std::max(int64_t(1), microseconds() - start);
+        std::cout << "properties"
+            ": requests: "  << count <<
+            " time: "       << elapsed * 1e-6 << " sec." <<
+            " requests/sec: " << count * 1e6 / elapsed <<
+        "\n";
+    }
+    return ret;
+}
+
 int
 main(int argc, char** argv)
 {
     if (argc <= 1 || (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help"))) {
+        std::cout << "Usage: " << (argc > 0 ? argv[0] : "requestparser") <<
+            " {flags|b [count]}\n"
+            "flags can be any combination of 'q', 'n', 'a', 'p'\n"
+            "q: quiet, n: do not parse, a: allocate, p: use properties\n"
+            "The requests are read from STDIN\n"
+            "b: parse built in allocate request, and mix of requests count\n"
+            "   times, and report requests/sec\n"
+        ;
         return 0;
     }
+    if (! strcmp(argv[1], "b")) {
+        return Benchmark(argc > 2 ? (int64_t)atoll(argv[2]) : int64_t(1000000));
+    }
 
     static char buf[1 << 20];
     char* ptr = buf;
@@ -0,0 +1,209 @@
+//---------------------------------------------------------- -*- Mode: C++ -*-
+// $Id$
+//
+// Created 2026/10/18
+//
+// Copyright 2026 Quantcast Corporation. All rights reserved.
+//
+// This file is part of Kosmos File System (KFS).
+//
+// Licensed under the Apache License, Version 2.0
+// (the "License"); you may not use this file except in compliance with
+// the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// \brief RPC response formatting benchmark. Compares IOBuffer::WOStream
+// (ostream) formatting with the meta server IntIOBufferWriter formatting of
+// the get layout response: chunk offset, id, version, and replica locations.
+// The writer loop is the same as the one in MetaGetlayout::handle().
+//
+//----------------------------------------------------------------------------
+
+#include "meta/util.h"
+#include "kfsio/IOBuffer.h"
+#include "kfsio/Globals.h"
+#include "common/time.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <string>
+#include <ostream>
+
+using namespace KFS;
+using std::string;
+using std::ostream;
+
+struct Chunk
+{
+    int64_t offset;
+    int64_t chunkId;
+    int64_t chunkVersion;
+};
+
+static const string kHosts[] = {
+    "10.6.47.101", "10.6.47.102", "10.6.52.213"
+};
+static const int         kNumReplicas = 3;
+static const int         kPort        = 22000;
+
+static void
+FormatStream(
+    IOBuffer::WOStream& stream,
+    IOBuffer&           buf,
+    const Chunk*        chunks,
+    int                 count)
+{
+    ostream& os = stream.Set(buf);
+    for (int i = 0; i < count; i++) {
+        const Chunk& c = chunks[i];
+        if (0 < i) {
+            os << " ";
+        }
+        os << c.offset << " " << c.chunkId << " " << c.chunkVersion <<
+            " " << kNumReplicas;
+        for (int k = 0; k < kNumReplicas; k++) {
+            os << " " << kHosts[k] << " " << kPort;
+        }
+    }
+    os.flush();
+    stream.Reset();
+}
+
+static void
+FormatWriter(
+    IOBuffer&    buf,
+    const Chunk* chunks,
+    int          count)
+{
+    const int         maxSize = 256 << 20;
+    IntIOBufferWriter writer(buf);
+    for (int i = 0; i < count; i++) {
+        const Chunk& c = chunks[i];
+        if (0 < i) {
+            writer.Write(" ", 1);
+        }
+        writer.WriteInt(c.offset);
+        writer.Write(" ", 1);
+        writer.WriteInt(c.chunkId);
+        writer.Write(" ", 1);
+        writer.WriteInt(c.chunkVersion);
+        writer.Write(" ", 1);
+        writer.WriteInt(kNumReplicas);
+        for (int k = 0; k < kNumReplicas; k++) {
+            writer.Write(" ", 1);
+            writer.Write(kHosts[k]);
+            writer.Write(" ", 1);
+            writer.WriteInt(kPort);
+        }
+        if (maxSize < writer.GetTotalSize()) {
+            buf.Clear();
+            return;
+        }
+    }
+    writer.Close();
+}
+
+static bool
+Equals(
+    const IOBuffer& buf,
+    const string&   str)
+{
+    if (buf.BytesConsumable() != (int)str.size()) {
+        return false;
+    }
+    size_t pos = 0;
+    for (IOBuffer::iterator it = buf.begin(); it != buf.end(); ++it) {
+        const size_t len = it->BytesConsumable();
+        if (memcmp(it->Consumer(), str.data() + pos, len) != 0) {
+            return false;
+        }
+        pos += len;
+    }
+    return true;
+}
+
+static string
+ToString(
+    const IOBuffer& buf)
+{
+    string ret;
+    for (IOBuffer::iterator it = buf.begin(); it != buf.end(); ++it) {
+        ret.append(it->Consumer(), it->BytesConsumable());
+    }
+    return ret;
+}
+
+int
+main(
+    int    argc,
+    char** argv)
+{
+    if (argc > 1 && (! strcmp(argv[1], "-h") || ! strcmp(argv[1], "--help"))) {
+        printf("Usage: %s [chunks per response] [iterations]\n"
+            "       Formats get layout like response with ostream and with"
+            " IntIOBufferWriter,\n"
+            "       and reports bytes/sec for each.\n",
+            argv[0]);
+        return 0;
+    }
+    const int count      = argc > 1 ? atoi(argv[1]) : 4096;
+    const int iterations = argc > 2 ? atoi(argv[2]) : 200;
+    if (count <= 0 || iterations <= 0) {
+        fprintf(stderr, "invalid arguments\n");
+        return 1;
+    }
+    libkfsio::InitGlobals();
+    Chunk* const chunks = new Chunk[count];
+    int64_t      seed   = 1;
+    for (int i = 0; i < count; i++) {
+        seed = seed * 6364136223846793005LL + 1442695040888963407LL;
+        chunks[i].offset       = (int64_t)i << 26;
+        chunks[i].chunkId      = 1000000000LL + (seed >> 40);
+        chunks[i].chunkVersion = 1 + ((seed >> 20) & 0xFFFF);
+    }
+    IOBuffer::WOStream stream;
+    IOBuffer           sbuf;
+    IOBuffer           wbuf;
+    FormatStream(stream, sbuf, chunks, count);
+    FormatWriter(wbuf, chunks, count);
+    if (! Equals(wbuf, ToString(sbuf))) {
+        fprintf(stderr, "error: ostream and writer output mismatch\n");
+        return 1;
+    }
+    const int64_t respSize = sbuf.BytesConsumable();
+    sbuf.Clear();
+    wbuf.Clear();
+
+    int64_t start = microseconds();
+    for (int i = 0; i < iterations; i++) {
+        FormatStream(stream, sbuf, chunks, count);
+        sbuf.Clear();
+    }
+    const int64_t streamTime = microseconds() - start;
+    start = microseconds();
+    for (int i = 0; i < iterations; i++) {
+        FormatWriter(wbuf, chunks, count);
+        wbuf.Clear();
+    }
+    const int64_t writerTime = microseconds() - start;
+    const double  total      = (double)respSize * iterations;
+    printf("response size: %" PRId64 " iterations: %d\n"
+        "ostream: %.3f sec. %.2f MB/sec\n"
+        "writer:  %.3f sec. %.2f MB/sec\n",
+        respSize, iterations,
+        streamTime * 1e-6, total / (1 << 20) / (streamTime * 1e-6 + 1e-9),
+        writerTime * 1e-6, total / (1 << 20) / (writerTime * 1e-6 + 1e-9)
+    );
+    delete [] chunks;
+    return 0;
+}
@@ -33,6 +33,7 @@
 
 #include <fuse.h>
 #include <sys/stat.h>
+#include <sys/statvfs.h>
 #include <unistd.h>
 #include <string.h>
 #include <stdarg.h>
@@ -53,9 +54,16 @@ using KFS::kKfsModeUndef;
 using KFS::Permissions;
 using KFS::KFS_STRIPED_FILE_TYPE_NONE;
 using KFS::Properties;
+using KFS::MAX_FILENAME_LEN;
 
 static KfsClient* client;
 
+// Largest read and write request size negotiated with the kernel. The fuse
+// library and kernel might impose lower limits.
+static const unsigned int kMaxIoSize = 1 << 20;
+// Block size reported by statfs, all space values are in these units.
+static const unsigned long kStatFsBlockSize = 64 << 10;
+
 static inline kfsMode_t
 mode2kfs_mode(mode_t mode)
 {
@@ -205,19 +213,22 @@ fuse_readdir(const char *path, void *buf,
              fuse_fill_dir_t filler, off_t offset,
              struct fuse_file_info *finfo)
 {
-    vector <KfsFileAttr> contents;
-    int status = client->ReaddirPlus(path, contents);
+    KfsClient::DirCursor cursor;
+    int status = client->OpenDir(path, cursor);
     if (status < 0)
         return status;
-    int n = contents.size();
-    for (int i = 0; i < n; i++) {
-        struct stat s;
-        contents[i].ToStat(s);
-        if (filler(buf, contents[i].filename.c_str(), &s, 0) != 0) {
-            break;
+    vector <KfsFileAttr> contents;
+    while ((status = client->NextEntries(cursor, contents)) > 0) {
+        int n = contents.size();
+        for (int i = 0; i < n; i++) {
+            struct stat s;
+            contents[i].ToStat(s);
+            if (filler(buf, contents[i].filename.c_str(), &s, 0) != 0) {
+                return 0;
+            }
         }
     }
-    return 0;
+    return status;
 }
 
 static int
@@ -260,81 +271,72 @@ fuse_chown(const char *path, uid_t user, gid_t group)
     );
 }
 
-struct fuse_operations ops = {
-        fuse_getattr,
-        NULL,                   /* readlink */
-        NULL,                   /* getdir */
-        NULL,                   /* mknod */
-        fuse_mkdir,
-        fuse_unlink,
-        fuse_rmdir,
-        NULL,                   /* symlink */
-        fuse_rename,
-        NULL,                   /* link */
-        fuse_chmod,             /* chmod */
-        fuse_chown,             /* chown */
-        fuse_truncate,
-        NULL,                   /* utime */
-        fuse_open,
-        fuse_read,
-        fuse_write,
-        NULL,                   /* statfs */
-        fuse_flush,             /* flush */
-        fuse_release,           /* release */
-        fuse_fsync,             /* fsync */
-        NULL,                   /* setxattr */
-        NULL,                   /* getxattr */
-        NULL,                   /* listxattr */
-        NULL,                   /* removexattr */
-        fuse_opendir,
-        fuse_readdir,
-        fuse_releasedir,
-        NULL,                   /* fsyncdir */
-        NULL,                   /* init */
-        NULL,                   /* destroy */
-        fuse_access,            /* access */
-        fuse_create,            /* create */
-        fuse_ftruncate,         /* ftruncate */
-        fuse_fgetattr,          /* fgetattr */
-};
-
-struct fuse_operations ops_readonly = {
-        fuse_getattr,
-        NULL,                   /* readlink */
-        NULL,                   /* getdir */
-        NULL,                   /* mknod */
-        NULL,                   /* mkdir */
-        NULL,                   /* unlink */
-        NULL,                   /* rmdir */
-        NULL,                   /* symlink */
-        NULL,                   /* rename */
-        NULL,                   /* link */
-        NULL,                   /* chmod */
-        NULL,                   /* chown */
-        NULL,                   /* truncate */
-        NULL,                   /* utime */
-        fuse_open,
-        fuse_read,
-        NULL,                   /* write */
-        NULL,                   /* statfs */
-        NULL,                   /* flush */
-        fuse_release,           /* release */
-        NULL,                   /* fsync */
-        NULL,                   /* setxattr */
-        NULL,                   /* getxattr */
-        NULL,                   /* listxattr */
-        NULL,                   /* removexattr */
-        fuse_opendir,
-        fuse_readdir,
-        NULL,                   /* releasedir */
-        NULL,                   /* fsyncdir */
-        NULL,                   /* init */
-        NULL,                   /* destroy */
-        fuse_access,            /* access */
-        NULL,                   /* create */
-        NULL,                   /* ftruncate */
-        fuse_fgetattr,          /* fgetattr */
-};
+static void*
+fuse_init(struct fuse_conn_info *conn)
+{
+    // Max write, read ahead, and async read are set with the file system
+    // arguments, see get_fs_args(), in order to allow to override these with
+    // the mount options.
+#ifdef FUSE_CAP_BIG_WRITES
+    conn->want |= conn->capable & FUSE_CAP_BIG_WRITES;
+#endif
+    return NULL;
+}
+
+static int
+fuse_statfs(const char *path, struct statvfs *s)
+{
+    int64_t total = 0;
+    int64_t used  = 0;
+    int64_t avail = 0;
+    const int status = client->GetFsSpace(total, used, avail);
+    if (status < 0) {
+        return status;
+    }
+    memset(s, 0, sizeof(*s));
+    s->f_bsize   = kStatFsBlockSize;
+    s->f_frsize  = kStatFsBlockSize;
+    s->f_blocks  = (fsblkcnt_t)(total / kStatFsBlockSize);
+    s->f_bfree   = (fsblkcnt_t)((total - used) / kStatFsBlockSize);
+    s->f_bavail  = (fsblkcnt_t)(avail / kStatFsBlockSize);
+    if (s->f_bfree < s->f_bavail) {
+        s->f_bfree = s->f_bavail;
+    }
+    s->f_namemax = MAX_FILENAME_LEN;
+    return 0;
+}
+
+static void
+init_ops(struct fuse_operations* ops, bool readonly)
+{
+    memset(ops, 0, sizeof(*ops));
+    ops->getattr    = fuse_getattr;
+    ops->fgetattr   = fuse_fgetattr;
+    ops->open       = fuse_open;
+    ops->read       = fuse_read;
+    ops->release    = fuse_release;
+    ops->opendir    = fuse_opendir;
+    ops->readdir    = fuse_readdir;
+    ops->access     = fuse_access;
+    ops->statfs     = fuse_statfs;
+    ops->init       = fuse_init;
+    if (readonly) {
+        return;
+    }
+    ops->mkdir      = fuse_mkdir;
+    ops->unlink     = fuse_unlink;
+    ops->rmdir      = fuse_rmdir;
+    ops->rename     = fuse_rename;
+    ops->chmod      = fuse_chmod;
+    ops->chown      = fuse_chown;
+    ops->truncate   = fuse_truncate;
+    ops->ftruncate  = fuse_ftruncate;
+    ops->write      = fuse_write;
+    ops->flush      = fuse_flush;
+    ops->fsync      = fuse_fsync;
+    ops->releasedir = fuse_releasedir;
+    ops->create     = fuse_create;
+}
 
 static void
 fatal(const char *fmt, ...)
@@ -389,21 +391,66 @@ initkfs(char* addr, const string& cfg_file, const string& cfg_props)
 }
 
 static struct fuse_args*
-get_fs_args(struct fuse_args* args)
+get_fs_args(struct fuse_args* args, const string& fs_options)
 {
-#ifdef KFS_OS_NAME_DARWIN
-    return NULL;
-#else
     if (! args) {
         return 0;
     }
-    args->argc = 2;
+    vector<string> argv;
+    argv.push_back("qfs_fuse");
+#ifndef KFS_OS_NAME_DARWIN
+    char buf[64];
+    argv.push_back("-obig_writes");
+    snprintf(buf, sizeof(buf), "-omax_write=%u", kMaxIoSize);
+    argv.push_back(buf);
+    snprintf(buf, sizeof(buf), "-omax_readahead=%u", kMaxIoSize);
+    argv.push_back(buf);
+#endif
+    if (! fs_options.empty()) {
+        // Specified last to override the above defaults.
+        argv.push_back("-o" + fs_options);
+    }
+    if (argv.size() <= 1) {
+        return NULL;
+    }
+    args->argc = (int)argv.size();
     args->argv = (char**)calloc(sizeof(char*), args->argc + 1);
-    args->argv[0] = strdup("qfs_fuse");
-    args->argv[1] = strdup("-obig_writes");
+    for (int i = 0; i < args->argc; i++) {
+        args->argv[i] = strdup(argv[i].c_str());
+    }
     args->allocated = 1;
     return args;
-#endif
+}
+
+/*
+ * Fuse library options: passed to fuse_new() with the file system arguments,
+ * instead of fuse_mount().
+ */
+static bool
+is_fs_option(const string& token)
+{
+    static const char* const fs_options[] = {
+        "attr_timeout=",
+        "entry_timeout=",
+        "negative_timeout=",
+        "ac_attr_timeout=",
+        "max_write=",
+        "max_readahead=",
+        "direct_io",
+        "kernel_cache",
+        "auto_cache",
+        "async_read",
+        "sync_read",
+        NULL
+    };
+    for (const char* const* p = fs_options; *p; ++p) {
+        const size_t len = strlen(*p);
+        if ((*p)[len - 1] == '=' ?
+                token.compare(0, len, *p) == 0 : token == *p) {
+            return true;
+        }
+    }
+    return false;
 }
 
 static struct fuse_args*
@@ -430,7 +477,7 @@ get_mount_args(struct fuse_args* args, const char* options)
 static int
 massage_options(
     char** opt_argv, int opt_argc, string* options, bool* readonly,
-    string& out_cfg_file, string& out_cfg_props)
+    string& out_cfg_file, string& out_cfg_props, string& out_fs_options)
 {
     if (!opt_argv || !readonly || !options) {
         return -1;
@@ -486,6 +533,13 @@ massage_options(
             }
             continue;
         }
+        if (is_fs_option(token)) {
+            if (! out_fs_options.empty()) {
+                out_fs_options.append(",");
+            }
+            out_fs_options.append(token);
+            continue;
+        }
         options->append(",");
         options->append(token);
     }
@@ -499,7 +553,8 @@ massage_options(
 static void
 initfuse(char* kfs_host_address, const char* mountpoint,
          const char* options, bool readonly, bool fork_flag,
-         const string& cfg_file, const string& cfg_props)
+         const string& cfg_file, const string& cfg_props,
+         const string& fs_options)
 {
     int pid = fork_flag ? fork() : 0;
     if (pid < 0) {
@@ -518,17 +573,19 @@ initfuse(char* kfs_host_address, const char* mountpoint,
             fatal("fuse_mount: %s:", mountpoint);
         }
 
+        struct fuse_operations ops;
+        init_ops(&ops, readonly);
         struct fuse* fuse = NULL;
-        fuse = fuse_new(ch, get_fs_args(&fs_args),
-                        (readonly ? &ops_readonly : &ops),
-                        (readonly ? sizeof(ops_readonly) : sizeof(ops)),
-                        NULL);
+        fuse = fuse_new(ch, get_fs_args(&fs_args, fs_options),
+                        &ops, sizeof(ops), NULL);
         if (fuse == NULL) {
             fuse_unmount(mountpoint, ch);
             delete client;
             fatal("fuse_new:");
         }
 
+        // KfsClient is thread safe, and blocking calls release its lock,
+        // therefore requests are processed concurrently.
         fuse_loop_mt(fuse);
         fuse_unmount(mountpoint, ch);
         fuse_destroy(fuse);
@@ -544,7 +601,12 @@ usage(int e, const char* name)
     fprintf(stderr,
         "usage: %s qfshost mountpoint [-o opt1[,opt2..]]\n"
         "       eg: %s 127.0.0.1:20000 "
-        "/mnt/qfs -o allow_other,ro,cfg=FILE:client_config_file.prp\n",
+        "/mnt/qfs -o allow_other,ro,cfg=FILE:client_config_file.prp\n"
+        "       fuse library options attr_timeout=, entry_timeout=,"
+        " negative_timeout=,\n"
+        "       max_write=, max_readahead=, direct_io, kernel_cache,"
+        " auto_cache are\n"
+        "       also accepted\n",
         name, name
     );
     exit(e);
@@ -579,9 +641,10 @@ main(int argc, char **argv)
     bool readonly = true;
     string cfg_file;
     string cfg_props;
+    string fs_options;
     if (argc > 2) {
         if (massage_options(argv + 2, argc - 2, &options, &readonly,
-                cfg_file, cfg_props) < 0) {
+                cfg_file, cfg_props, fs_options) < 0) {
             usage(1, name);
         }
     }
@@ -589,7 +652,7 @@ main(int argc, char **argv)
     //setsid(); // detach from console
 
     initfuse(argv[0], argv[1], options.c_str(), readonly,
-        fork_flag, cfg_file, cfg_props);
+        fork_flag, cfg_file, cfg_props, fs_options);
 
     return 0;
 }
@@ -41,9 +41,11 @@ Acceptor::Acceptor(
     const ServerLocation& location,
     bool                  ipV6OnlyFlag,
     IAcceptorOwner*       owner,
-    bool                  bindOnlyFlag)
+    bool                  bindOnlyFlag,
+    bool                  reusePortFlag)
     : mLocation(location),
       mIpV6OnlyFlag(ipV6OnlyFlag),
+      mReusePortFlag(reusePortFlag),
       mAcceptorOwner(owner),
       mConn(),
       mNetManager(netManager)
@@ -62,6 +64,7 @@ Acceptor::Acceptor(
     bool            bindOnlyFlag /* = false */)
     : mLocation(string(), port),
       mIpV6OnlyFlag(false),
+      mReusePortFlag(false),
       mAcceptorOwner(owner),
       mConn(),
       mNetManager(netManager)
@@ -96,7 +99,8 @@ Acceptor::Bind()
         mLocation,
         (mLocation.hostname.empty() && mIpV6OnlyFlag) ?
             TcpSocket::kTypeIpV6 : TcpSocket::kTypeIpV4,
-        mIpV6OnlyFlag
+        mIpV6OnlyFlag,
+        mReusePortFlag
     );
     if (res < 0) {
         KFS_LOG_STREAM_ERROR <<
@@ -92,7 +92,8 @@ public:
         const ServerLocation& location,
         bool                  ipV6OnlyFlag,
         IAcceptorOwner*       owner,
-        bool                  bindOnlyFlag);
+        bool                  bindOnlyFlag,
+        bool                  reusePortFlag = false);
     ~Acceptor();
     void StartListening();
 
@@ -119,6 +120,7 @@ private:
     ///
     ServerLocation        mLocation;
     bool                  mIpV6OnlyFlag;
+    bool                  mReusePortFlag;
     IAcceptorOwner* const mAcceptorOwner;
     NetConnectionPtr      mConn;
     NetManager&           mNetManager;
@@ -43,6 +43,10 @@ Globals_t::Globals_t()
       ctrDiskBytesRead   ("Bytes read from disk"),
       ctrDiskBytesWritten("Bytes written to disk"),
       ctrDiskIOErrors    ("Disk I/O errors"),
+      ctrSslHandshakes     ("SSL handshakes"),
+      ctrSslSessionsResumed("SSL sessions resumed"),
+      ctrSslBytesRead      ("SSL bytes read"),
+      ctrSslBytesWritten   ("SSL bytes written"),
       mInitedFlag(false),
       mDestructedFlag(false),
       mForGdbToFindNetManager(0)
@@ -54,6 +58,10 @@ Globals_t::Globals_t()
     counterManager.AddCounter(&ctrDiskBytesRead);
     counterManager.AddCounter(&ctrDiskBytesWritten);
     counterManager.AddCounter(&ctrDiskIOErrors);
+    counterManager.AddCounter(&ctrSslHandshakes);
+    counterManager.AddCounter(&ctrSslSessionsResumed);
+    counterManager.AddCounter(&ctrSslBytesRead);
+    counterManager.AddCounter(&ctrSslBytesWritten);
     sForGdbToFindInstance = this;
 }
 
@@ -48,6 +48,10 @@ struct Globals_t
     Counter ctrDiskBytesWritten;
     // track the # of failed read/writes
     Counter ctrDiskIOErrors;
+    Counter ctrSslHandshakes;
+    Counter ctrSslSessionsResumed;
+    Counter ctrSslBytesRead;
+    Counter ctrSslBytesWritten;
     void Init();
     static NetManager& getNetManager();
     static void Destroy();
@@ -76,12 +76,92 @@ NetManager::NetManager(int timeoutMs)
       mPendingReadList(),
       mPendingUpdate(),
       mCurTimeoutHandler(0),
-      mEpollError()
+      mEpollError(),
+      mTimerMsCount(0),
+      mTimerMsWheel(ITimeout::NowMs()),
+      mMainLoopMutex(0)
 {
     TimeoutHandlers::Init(mTimeoutHandlers);
     mPendingUpdate.reserve(1 << 10);
 }
 
+class NetManager::TimerMsExpired
+{
+public:
+    TimerMsExpired(NetManager& netManager, int64_t nowMs)
+        : mNetManager(netManager),
+          mNowMs(nowMs)
+        {}
+    void operator()(TimerMsEntry& entry)
+    {
+        TimerMs& timer = static_cast<TimerMs&>(entry);
+        if (mNowMs < timer.mExpirationTimeMs) {
+            // Not expired yet -- max timeout exceeds the wheel span.
+            mNetManager.mTimerMsWheel.Schedule(entry, timer.mExpirationTimeMs);
+            return;
+        }
+        TimerMsEntry::List::Remove(entry);
+        mNetManager.mTimerMsCount--;
+        timer.mObj.HandleEvent(EVENT_INACTIVITY_TIMEOUT, 0);
+    }
+private:
+    NetManager&   mNetManager;
+    const int64_t mNowMs;
+};
+
+void
+NetManager::ScheduleTimerMs(TimerMs& timer, int tmMs)
+{
+    assert(&timer.mNetManager == this);
+    // The wheel is protected by the main loop mutex, if any.
+    assert(! mMainLoopMutex || mMainLoopMutex->IsOwned());
+    if (! TimerMsEntry::List::IsInList(timer)) {
+        mTimerMsCount++;
+    }
+    timer.mExpirationTimeMs = ITimeout::NowMs() + max(0, tmMs);
+    mTimerMsWheel.Schedule(timer, timer.mExpirationTimeMs);
+    if (mPollFlag) {
+        // Scheduled by other thread holding the main loop mutex while
+        // polling, the poll timeout needs to be adjusted.
+        assert(mMainLoopMutex);
+        Wakeup();
+    }
+}
+
+void
+NetManager::CancelTimerMs(TimerMs& timer)
+{
+    assert(! mMainLoopMutex || mMainLoopMutex->IsOwned());
+    if (! TimerMsEntry::List::IsInList(timer)) {
+        return;
+    }
+    TimerMsEntry::List::Remove(timer);
+    mTimerMsCount--;
+    assert(0 <= mTimerMsCount);
+}
+
+int
+NetManager::GetPollTimeoutMs(int timeoutMs) const
+{
+    if (mTimerMsCount <= 0 || timeoutMs <= 0) {
+        return timeoutMs;
+    }
+    const int64_t nowMs = ITimeout::NowMs();
+    const int64_t next  = mTimerMsWheel.GetNextRunTime(nowMs, nowMs + timeoutMs);
+    return (next <= nowMs ? 0 : (int)(next - nowMs));
+}
+
+void
+NetManager::RunTimersMs()
+{
+    if (mTimerMsCount <= 0) {
+        return;
+    }
+    const int64_t  nowMs = ITimeout::NowMs();
+    TimerMsExpired expired(*this, nowMs);
+    mTimerMsWheel.Run(nowMs, expired);
+}
+
 NetManager::~NetManager()
 {
     NetManager::CleanUp();
@@ -367,6 +447,7 @@ NetManager::MainLoop(
 {
     QCStMutexLocker locker(mutex);
 
+    mMainLoopMutex = mutex;
     if (! runOnceFlag || mLastTimerTime != mNow) {
         mNow           = time(0);
         mLastTimerTime = mNow;
@@ -405,7 +486,7 @@ NetManager::MainLoop(
             dispatcher->DispatchEnd();
         }
         const int timeout = PendingReadList::IsInList(mPendingReadList) ?
-            0 : mTimeoutMs;
+            0 : GetPollTimeoutMs(mTimeoutMs);
         const int fdCount = mConnectionsCount + 1;
         assert(mPendingUpdate.empty());
         mPollFlag = true;
@@ -439,6 +520,7 @@ NetManager::MainLoop(
             }
             cur.TimerExpired(nowMs);
         }
+        RunTimersMs();
         // Move pending read list into temporary list, as the pending read might
         // change as a result of event dispatch.
         NetManagerEntry pendingRead;
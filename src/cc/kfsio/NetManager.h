@@ -32,6 +32,7 @@
 
 #include "NetConnection.h"
 #include "ITimeout.h"
+#include "common/TimerWheel.h"
 
 #include <list>
 #include <vector>
@@ -200,6 +201,64 @@ public:
         Timer& operator=(const Timer&);
     };
 
+    // One shot timer with millisecond resolution, and with O(1) schedule
+    // and cancel. Intended for short timeouts, where the second resolution of
+    // the connection timer wheel is too coarse. On expiration the obj
+    // is invoked with EVENT_INACTIVITY_TIMEOUT. The timer must not outlive its
+    // net manager. If the main loop runs with a mutex, then schedule and cancel
+    // must be invoked with this mutex held.
+    class TimerMsEntry
+    {
+    public:
+        TimerMsEntry()
+            { List::Init(*this); }
+        ~TimerMsEntry()
+            { List::Remove(*this); }
+    protected:
+        typedef QCDLListOp<TimerMsEntry> List;
+    private:
+        TimerMsEntry* mPrevPtr[1];
+        TimerMsEntry* mNextPtr[1];
+
+        friend class QCDLListOp<TimerMsEntry>;
+        friend class NetManager;
+    private:
+        TimerMsEntry(const TimerMsEntry&);
+        TimerMsEntry& operator=(const TimerMsEntry&);
+    };
+    class TimerMs : public TimerMsEntry
+    {
+    public:
+        TimerMs(NetManager& netManager, KfsCallbackObj& obj)
+            : TimerMsEntry(),
+              mNetManager(netManager),
+              mObj(obj),
+              mExpirationTimeMs(-1)
+            {}
+        ~TimerMs()
+            { TimerMs::Cancel(); }
+        // (Re)schedule to expire in tmMs milliseconds from now.
+        void Schedule(int tmMs)
+            { mNetManager.ScheduleTimerMs(*this, tmMs); }
+        void Cancel()
+            { mNetManager.CancelTimerMs(*this); }
+        bool IsScheduled() const
+            { return List::IsInList(*this); }
+        int64_t GetExpirationTimeMs() const
+            { return mExpirationTimeMs; }
+    private:
+        NetManager&     mNetManager;
+        KfsCallbackObj& mObj;
+        int64_t         mExpirationTimeMs;
+
+        friend class NetManager;
+    private:
+        TimerMs(const TimerMs&);
+        TimerMs& operator=(const TimerMs&);
+    };
+    int GetTimerMsCount() const
+        { return mTimerMsCount; }
+
     /// Method used by NetConnection only.
     static void Update(NetManagerEntry& entry, int fd,
         bool resetTimer);
@@ -210,6 +269,17 @@ private:
     typedef NetManagerEntry::PendingReadList PendingReadList;
     typedef vector<NetConnection*>           PendingUpdate;
     enum { kTimerWheelSize = (1 << 8) };
+    enum { kTimerMsWheelSize = (1 << 10) };
+    enum { kTimerMsResolution = 2 };
+    typedef TimerWheel<
+        TimerMsEntry,
+        QCDLListOp<TimerMsEntry>,
+        int64_t,
+        kTimerMsWheelSize,
+        kTimerMsResolution
+    > TimerMsWheel;
+    class TimerMsExpired;
+    friend class TimerMsExpired;
 
     List            mRemove;
     List::iterator  mTimerWheelBucketItr;
@@ -247,6 +317,9 @@ private:
     ITimeout*       mTimeoutHandlers[1];
     List            mEpollError;
     List            mTimerWheel[kTimerWheelSize + 1];
+    int             mTimerMsCount;
+    TimerMsWheel    mTimerMsWheel;
+    QCMutex*        mMainLoopMutex;
 
     void CheckIfOverloaded();
     void CleanUp(bool childAtForkFlag = false, bool onlyCloseFdFlag = false);
@@ -254,6 +327,10 @@ private:
     void UpdateSelf(NetManagerEntry& entry, int fd,
         bool resetTimer, bool epollError);
     void PollRemove(int fd);
+    void ScheduleTimerMs(TimerMs& timer, int tmMs);
+    void CancelTimerMs(TimerMs& timer);
+    int GetPollTimeoutMs(int timeoutMs) const;
+    void RunTimersMs();
 private:
     NetManager(const NetManager&);
     NetManager& operator=(const NetManager&);
@@ -185,7 +185,11 @@ public:
         if (! theRetPtr) {
             return 0;
         }
-        SSL_CTX_set_mode(theRetPtr, SSL_MODE_ENABLE_PARTIAL_WRITE);
+        // Moving write buffer is needed by Write(), as the retry might use
+        // record buffer instead of io buffer fragment, and vice versa.
+        SSL_CTX_set_mode(theRetPtr,
+            SSL_MODE_ENABLE_PARTIAL_WRITE |
+            SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
         Properties::String theParamName;
         if (inParamsPrefixPtr) {
             theParamName.Append(inParamsPrefixPtr);
@@ -398,6 +402,7 @@ public:
           mAuthName(),
           mPeerPskId(),
           mPeerName(),
+          mRecordBufPtr(0),
           mServerPskPtr(inServerPskPtr),
           mVerifyPeerPtr(inVerifyPeerPtr),
           mReadPendingFlag(inReadPendingFlag),
@@ -410,7 +415,8 @@ public:
           mSslErrorFlag(false),
           mShutdownCompleteFlag(false),
           mVerifyOrGetPskInvokedFlag(false),
-          mRenegotiationPendingFlag(false)
+          mRenegotiationPendingFlag(false),
+          mHandshakeCountedFlag(false)
     {
         if (! mSslPtr) {
             return;
@@ -442,6 +448,7 @@ public:
             SSL_set_session(mSslPtr, 0);
             SSL_free(mSslPtr);
         }
+        delete [] mRecordBufPtr;
     }
     Error GetError() const
         { return mError; }
@@ -541,12 +548,26 @@ public:
         for (IOBuffer::iterator theIt = inIoBuffer.begin();
                 theIt != inIoBuffer.end();
                 ) {
-            const int theNWr = theIt->BytesConsumable();
+            int theNWr = theIt->BytesConsumable();
             if (theNWr <= 0) {
                 ++theIt;
                 continue;
             }
-            if ((theRet = SSL_write(mSslPtr, theIt->Consumer(), theNWr)) <= 0) {
+            // Coalesce small io buffer fragments into full size ssl record,
+            // in order to reduce per record overhead and the number of socket
+            // writes. The record buffer content is always a prefix of io
+            // buffer content, therefore ssl write retry with the same or
+            // larger length is valid.
+            const char* thePtr = theIt->Consumer();
+            if (theNWr < kMaxRecordSize &&
+                    theNWr < inIoBuffer.BytesConsumable()) {
+                if (! mRecordBufPtr) {
+                    mRecordBufPtr = new char[kMaxRecordSize];
+                }
+                theNWr = inIoBuffer.CopyOut(mRecordBufPtr, kMaxRecordSize);
+                thePtr = mRecordBufPtr;
+            }
+            if ((theRet = SSL_write(mSslPtr, thePtr, theNWr)) <= 0) {
                 break;
             }
             theWrCnt += theRet;
@@ -555,6 +576,7 @@ public:
         }
         if (0 < theWrCnt) {
             globals().ctrNetBytesWritten.Update(theWrCnt);
+            globals().ctrSslBytesWritten.Update(theWrCnt);
             return theWrCnt;
         }
         return SslRetToErr(theRet);
@@ -613,6 +635,7 @@ public:
             mSslEofFlag                = false;
             mSslErrorFlag              = false;
             mVerifyOrGetPskInvokedFlag = false;
+            mHandshakeCountedFlag      = false;
             mAuthName.clear();
             mPeerPskId.clear();
             mServerFlag = ! SSL_in_connect_init(mSslPtr);
@@ -678,6 +701,7 @@ public:
             thePtr += theRet;
         }
         if (theStartPtr < thePtr) {
+            globals().ctrSslBytesRead.Update(thePtr - theStartPtr);
             return (int)(thePtr - theStartPtr);
         }
         const int theErr = SslRetToErr(theRet);
@@ -768,6 +792,7 @@ private:
     string            mAuthName;
     string            mPeerPskId;
     string            mPeerName;
+    char*             mRecordBufPtr;
     ServerPsk* const  mServerPskPtr;
     VerifyPeer* const mVerifyPeerPtr;
     bool&             mReadPendingFlag;
@@ -781,6 +806,10 @@ private:
     bool              mShutdownCompleteFlag:1;
     bool              mVerifyOrGetPskInvokedFlag:1;
     bool              mRenegotiationPendingFlag:1;
+    bool              mHandshakeCountedFlag:1;
+
+    // Max ssl / tls record payload size.
+    enum { kMaxRecordSize = 16 << 10 };
 
     struct OpenSslInit
     {
@@ -1046,6 +1075,9 @@ private:
             if (! VerifyPeerIfNeeded()) {
                 return -EINVAL;
             }
+            if (! mHandshakeCountedFlag) {
+                HandshakeDone();
+            }
             if (! mServerFlag && ! mSessionStoredFlag) {
                 StoreClientSession();
             }
@@ -1053,6 +1085,7 @@ private:
         }
         if (mRenegotiationPendingFlag) {
             mVerifyOrGetPskInvokedFlag = false;
+            mHandshakeCountedFlag      = false;
         }
         mRenegotiationPendingFlag = false;
         ERR_clear_error();
@@ -1061,6 +1094,7 @@ private:
             if (! VerifyPeerIfNeeded()) {
                 return -EINVAL;
             }
+            HandshakeDone();
             // Try to update in case of renegotiation.
             StoreClientSession();
             return 0;
@@ -1071,6 +1105,14 @@ private:
         }
         return theRet;
     }
+    void HandshakeDone()
+    {
+        mHandshakeCountedFlag = true;
+        globals().ctrSslHandshakes.Update(1);
+        if (SSL_session_reused(mSslPtr)) {
+            globals().ctrSslSessionsResumed.Update(1);
+        }
+    }
     int SslRetToErr(
         int inRet)
     {
@@ -261,7 +261,8 @@ TcpSocket::StartListening(bool nonBlockingAccept, int maxQueue)
 }
 
 int
-TcpSocket::Bind(const ServerLocation& location, Type type, bool ipV6OnlyFlag)
+TcpSocket::Bind(const ServerLocation& location, Type type, bool ipV6OnlyFlag,
+    bool reusePortFlag)
 {
     Close();
     if (sMaxOpenSockets <= globals().ctrOpenNetFds.GetValue()) {
@@ -297,6 +298,16 @@ TcpSocket::Bind(const ServerLocation& location, Type type, bool ipV6OnlyFlag)
     if (SetSockOpt(mSockFd, SOL_SOCKET, SO_REUSEADDR, flag)) {
         Perror("setsockopt SO_REUSEADDR");
     }
+    if (reusePortFlag) {
+#ifdef SO_REUSEPORT
+        if (SetSockOpt(mSockFd, SOL_SOCKET, SO_REUSEPORT, flag)) {
+            return PerrorFatal("setsockopt SO_REUSEPORT");
+        }
+#else
+        Close();
+        return -EOPNOTSUPP;
+#endif
+    }
     if (bind(mSockFd, addr.Ptr(), addr.Size())) {
         return PerrorFatal(addr);
     }
@@ -311,7 +322,13 @@ TcpSocket::Accept(int* status /* = 0 */)
     TcpSocket* accSock;
     socklen_t  cliAddrLen = cliAddr.Size();
 
+#if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
+    // Set non blocking and close on exec flags with the same system call.
+    if ((fd = accept4(mSockFd, cliAddr.Ptr(), &cliAddrLen,
+            SOCK_NONBLOCK | SOCK_CLOEXEC)) < 0) {
+#else
     if ((fd = accept(mSockFd, cliAddr.Ptr(), &cliAddrLen)) < 0) {
+#endif
         const int err = errno;
         if (err != EAGAIN && err != EWOULDBLOCK) {
             Perror("accept", err);
@@ -328,12 +345,14 @@ TcpSocket::Accept(int* status /* = 0 */)
         }
         return 0;
     }
+#if ! defined(SOCK_NONBLOCK) || ! defined(SOCK_CLOEXEC)
     if (fcntl(fd, F_SETFD, FD_CLOEXEC)) {
         Perror("set FD_CLOEXEC");
     }
     if (fcntl(fd, F_SETFL, O_NONBLOCK)) {
         Perror("set O_NONBLOCK");
     }
+#endif
     accSock = new TcpSocket(fd, mType);
     accSock->SetupSocket();
     UpdateSocketCount(1);
@@ -62,7 +62,10 @@ public:
     ~TcpSocket();
 
     /// Setup and bind TCP socket to the port specified.
-    int Bind(const ServerLocation& location, Type type, bool ipV6OnlyFlag);
+    /// With reusePortFlag set SO_REUSEPORT is enabled, in order to allow
+    /// multiple listening sockets bound to the same port.
+    int Bind(const ServerLocation& location, Type type, bool ipV6OnlyFlag,
+        bool reusePortFlag = false);
 
     /// Start listening;
     int StartListening(bool nonBlockingAccept, int maxQueue = 8192);
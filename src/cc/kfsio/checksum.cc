@@ -259,5 +259,49 @@ ComputeCrc32(const char* data, size_t len, uint32_t cchksum /* = 0 */)
     return crc32(cchksum, reinterpret_cast<const Bytef*>(data), len);
 }
 
+char*
+ChecksumsToHex(const uint32_t* chksums, size_t cnt, char* buf)
+{
+    static const char* const kHexDigits = "0123456789ABCDEF";
+    char* ptr = buf;
+    for (size_t i = 0; i < cnt; i++) {
+        const uint32_t cks = chksums[i];
+        for (int k = (int)kChecksumHexWidth - 1; 0 <= k; k--) {
+            *ptr++ = kHexDigits[(cks >> (k * 4)) & 0xF];
+        }
+    }
+    return ptr;
+}
+
+bool
+HexToChecksums(const char* str, size_t len, size_t cnt, vector<uint32_t>& vec)
+{
+    if (len != cnt * kChecksumHexWidth) {
+        return false;
+    }
+    vec.clear();
+    vec.reserve(cnt);
+    const char* ptr = str;
+    for (size_t i = 0; i < cnt; i++) {
+        uint32_t cks = 0;
+        for (size_t k = 0; k < kChecksumHexWidth; k++) {
+            const int sym = *ptr++ & 0xFF;
+            int       hex;
+            if ('0' <= sym && sym <= '9') {
+                hex = sym - '0';
+            } else if ('A' <= sym && sym <= 'F') {
+                hex = sym - 'A' + 10;
+            } else if ('a' <= sym && sym <= 'f') {
+                hex = sym - 'a' + 10;
+            } else {
+                return false;
+            }
+            cks = (cks << 4) | (uint32_t)hex;
+        }
+        vec.push_back(cks);
+    }
+    return true;
+}
+
 }
 
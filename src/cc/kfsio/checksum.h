@@ -71,6 +71,19 @@ vector<uint32_t> ComputeChecksums(
 
 uint32_t ComputeCrc32(const char* data, size_t len, uint32_t cchksum = 0);
 
+/// Fixed width checksum vector encoding used by "Checksums-hex" rpc header:
+/// kChecksumHexWidth hex digits per entry without separators. This is only a
+/// more compact text encoding of the read reply checksum vector, the rpc
+/// header framing remains the same text key / value protocol.
+const size_t kChecksumHexWidth = 2 * sizeof(uint32_t);
+
+/// Writes cnt * kChecksumHexWidth bytes into buf, returns end of the output.
+char* ChecksumsToHex(const uint32_t* chksums, size_t cnt, char* buf);
+/// Returns false if len is not cnt * kChecksumHexWidth, or if the string
+/// contains non hex characters.
+bool HexToChecksums(const char* str, size_t len, size_t cnt,
+    vector<uint32_t>& vec);
+
 }
 
 #endif // CHUNKSERVER_CHECKSUM_H
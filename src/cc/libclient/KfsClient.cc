@@ -86,6 +86,7 @@ using std::transform;
 using std::numeric_limits;
 using std::unique;
 using std::find;
+using std::binary_search;
 using std::ostringstream;
 using std::cerr;
 
@@ -299,6 +300,20 @@ KfsClient::OpenDirectory(const char *pathname)
     return mImpl->OpenDirectory(pathname);
 }
 
+int
+KfsClient::OpenDir(const char *pathname, KfsClient::DirCursor& cursor,
+    bool computeFilesize, bool fileIdAndTypeOnly)
+{
+    return mImpl->OpenDir(pathname, cursor, computeFilesize, fileIdAndTypeOnly);
+}
+
+int
+KfsClient::NextEntries(KfsClient::DirCursor& cursor,
+    vector<KfsFileAttr>& result)
+{
+    return mImpl->NextEntries(cursor, result);
+}
+
 int
 KfsClient::Stat(const char *pathname, KfsFileAttr& result, bool computeFilesize)
 {
@@ -1028,6 +1043,13 @@ KfsClient::GetStats()
     return mImpl->GetStats();
 }
 
+int
+KfsClient::GetFsSpace(int64_t& totalSpace, int64_t& usedSpace,
+    int64_t& freeSpace)
+{
+    return mImpl->GetFsSpace(totalSpace, usedSpace, freeSpace);
+}
+
 static int
 LoadConfig(const char* configEnvName, const char* cfg, Properties& props)
 {
@@ -1539,6 +1561,13 @@ KfsClientImpl::KfsClientImpl(
       mFileAttributeRevalidateTime(30),
       mFileAttributeRevalidateScan(64),
       mFAttrCacheGeneration(1),
+      mTrackDirChangesFlag(false),
+      mDirChangeSeq(0),
+      mFsSpaceCacheTime(5),
+      mFsSpaceUpdateTime(0),
+      mFsTotalSpace(-1),
+      mFsUsedSpace(-1),
+      mFsFreeSpace(-1),
       mTmpPath(),
       mTmpAbsPathStr(),
       mTmpAbsPath(),
@@ -1748,6 +1777,10 @@ int KfsClientImpl::Init(const string& metaServerHost, int metaServerPort,
         } else if ((int)CHECKSUM_BLOCKSIZE <= defaultIoBufferSize) {
             mDefaultReadAheadSize = mDefaultIoBufferSize;
         }
+        mTrackDirChangesFlag = properties->getValue(
+            "client.trackDirChanges", mTrackDirChangesFlag ? 1 : 0) != 0;
+        mFsSpaceCacheTime = properties->getValue(
+            "client.fsSpaceCacheTime", mFsSpaceCacheTime);
         mConfig.clear();
         properties->copyWithPrefix("client.", mConfig);
     }
@@ -3133,6 +3166,162 @@ KfsClientImpl::ReaddirPlus(const string& pathname, kfsFileId_t dirFid,
     return 0;
 }
 
+int
+KfsClientImpl::OpenDir(const char* pathname, KfsClient::DirCursor& cursor,
+    bool computeFilesize, bool fileIdAndTypeOnly)
+{
+    QCStMutexLocker l(mMutex);
+
+    cursor.mDoneFlag = true;
+    cursor.mFnameStart.clear();
+    cursor.mPrevNames.clear();
+    KfsFileAttr attr;
+    const int res = StatSelf(pathname, attr, false, &cursor.mPathName);
+    if (res < 0) {
+        return res;
+    }
+    if (! attr.isDirectory) {
+        return -ENOTDIR;
+    }
+    cursor.mDirFid                = attr.fileId;
+    cursor.mComputeFilesizeFlag   = computeFilesize;
+    cursor.mFileIdAndTypeOnlyFlag = fileIdAndTypeOnly;
+    cursor.mDoneFlag              = false;
+    return 0;
+}
+
+int
+KfsClientImpl::NextEntries(KfsClient::DirCursor& cursor,
+    vector<KfsFileAttr>& result)
+{
+    QCStMutexLocker l(mMutex);
+    return NextEntriesSelf(cursor, result);
+}
+
+///
+/// Fetch and parse single readdirplus response. The directory attributes
+/// cache is not updated, as the caller is presumably scanning the directory.
+///
+int
+KfsClientImpl::NextEntriesSelf(KfsClient::DirCursor& cursor,
+    vector<KfsFileAttr>& result)
+{
+    assert(mMutex.IsOwned());
+    result.clear();
+    if (cursor.mDoneFlag) {
+        return 0;
+    }
+    const bool    kGetLastChunkInfoIfSizeUnknown = true;
+    ReaddirPlusOp op(
+        0, cursor.mDirFid, kGetLastChunkInfoIfSizeUnknown,
+        ! cursor.mComputeFilesizeFlag, cursor.mFileIdAndTypeOnlyFlag);
+    int retryCnt = kMaxReadDirRetries;
+    while (! cursor.mDoneFlag && result.empty()) {
+        op.seq                = 0;
+        op.numEntries         = kMaxReaddirEntries;
+        op.contentLength      = 0;
+        op.hasMoreEntriesFlag = false;
+        op.fnameStart         = cursor.mFnameStart;
+        op.status             = 0;
+
+        DoMetaOpWithRetry(&op);
+
+        cursor.mDoneFlag = true;
+        if (op.status < 0) {
+            if (op.fnameStart.empty() ||
+                    (op.status != -ENOENT && op.status != -EAGAIN)) {
+                break;
+            }
+            // The resume entry was removed. Resume from the entry preceding
+            // it in the previous response. The entries returned with the
+            // previous response are removed below.
+            if (! cursor.mPrevNames.empty() &&
+                    cursor.mPrevNames.back() == cursor.mFnameStart) {
+                cursor.mPrevNames.pop_back();
+            }
+            if (--retryCnt <= 0 || cursor.mPrevNames.empty()) {
+                KFS_LOG_STREAM_ERROR <<
+                    cursor.mPathName << ": id: " << cursor.mDirFid <<
+                    " directory has changed " <<
+                    (kMaxReadDirRetries - retryCnt) <<
+                    " times while attempting to list it; giving up" <<
+                KFS_LOG_EOM;
+                op.status = -EAGAIN;
+                break;
+            }
+            cursor.mFnameStart = cursor.mPrevNames.back();
+            cursor.mDoneFlag   = false;
+            continue;
+        }
+        if (op.numEntries <= 0) {
+            break;
+        }
+        if (op.contentLength <= 0) {
+            op.status = -EIO;
+            break;
+        }
+        ReaddirResult             opResult;
+        ReadDirPlusResponseParser parser(*this, result,
+            cursor.mComputeFilesizeFlag && ! cursor.mFileIdAndTypeOnlyFlag,
+            cursor.mDirFid, time(0));
+        if (op.hasMoreEntriesFlag) {
+            PropertiesTokenizer tokenizer(
+                op.contentBuf, op.contentLength, false);
+            tokenizer.Next();
+            const bool shortFlag = tokenizer.GetKey() == parser.shortBeginEntry;
+            opResult.Set(op);
+            if (! opResult.GetLast(
+                    shortFlag ? parser.shortBeginEntry : parser.beginEntry,
+                    PropertiesTokenizer::Token(shortFlag ? "N" : "Name"),
+                    cursor.mFnameStart)) {
+                op.status = -EIO;
+                break;
+            }
+            cursor.mDoneFlag = false;
+        } else {
+            opResult.Set(op);
+        }
+        if ((op.status = opResult.Parse(parser)) != 0) {
+            cursor.mDoneFlag = true;
+            break;
+        }
+        ComputeFilesizes(result, parser.fileChunkInfo);
+        vector<string> names;
+        names.reserve(result.size());
+        for (size_t i = 0; i < result.size(); i++) {
+            names.push_back(result[i].filename);
+        }
+        if (! cursor.mPrevNames.empty()) {
+            // The meta server doesn't guarantee that listing restarts from
+            // the exact same position if there were entry names hash
+            // collisions, and the resume entry was removed and added back
+            // right before the readdir rpc execution. Listing also restarts
+            // from an earlier entry if the resume entry was removed. Remove
+            // the entries returned with the previous response, if any.
+            vector<string> prev(cursor.mPrevNames);
+            sort(prev.begin(), prev.end());
+            size_t cnt = 0;
+            for (size_t i = 0; i < result.size(); i++) {
+                if (binary_search(prev.begin(), prev.end(),
+                        result[i].filename)) {
+                    continue;
+                }
+                if (cnt != i) {
+                    result[cnt] = result[i];
+                }
+                cnt++;
+            }
+            result.erase(result.begin() + cnt, result.end());
+        }
+        cursor.mPrevNames.swap(names);
+    }
+    if (op.status != 0) {
+        result.clear();
+        return GetOpStatus(op);
+    }
+    return (int)result.size();
+}
+
 int
 KfsClientImpl::Stat(const char *pathname, KfsFileAttr& kfsattr, bool computeFilesize)
 {
@@ -3745,9 +3934,16 @@ KfsClientImpl::OpenDirectory(const char *pathname)
         ReleaseFileTableEntry(fd);
         return -ENOTDIR;
     }
-    assert(! entry.dirEntries);
+    assert(! entry.dirEntries && ! entry.dirCursor);
     entry.dirEntries = new vector<KfsFileAttr>();
-    const int res = ReaddirPlus(path, entry.fattr.fileId, *entry.dirEntries);
+    entry.dirCursor  = new KfsClient::DirCursor();
+    KfsClient::DirCursor& cursor = *entry.dirCursor;
+    cursor.mPathName = path;
+    cursor.mDirFid   = entry.fattr.fileId;
+    cursor.mDoneFlag = false;
+    // Fetch the directory one page at a time, ReadDirectory() fetches the
+    // next page when the current one is consumed.
+    const int res = NextEntriesSelf(cursor, *entry.dirEntries);
     if (res < 0) {
         Close(fd);
         return res;
@@ -3799,6 +3995,14 @@ KfsClientImpl::ReadDirectory(int fd, char* buf, size_t numBytes)
     if (entry.currPos.fileOffset < 0) {
         entry.currPos.fileOffset = 0;
     }
+    if (dirEntries.size() <= (size_t)entry.currPos.fileOffset &&
+            entry.dirCursor && ! entry.dirCursor->IsDone()) {
+        const int res = NextEntriesSelf(*entry.dirCursor, *entry.dirEntries);
+        if (res < 0) {
+            return res;
+        }
+        entry.currPos.fileOffset = 0;
+    }
     int8_t*       ptr = (int8_t*)buf;
     int8_t* const end = ptr + numBytes;
     kfsUid_t      uid = kKfsUserNone;
@@ -4618,6 +4822,13 @@ KfsClientImpl::StartProtocolWorker()
     }
     params.mUseClientPoolFlag = mConfig.getValue(
         "client.connectionPool", params.mUseClientPoolFlag ? 1 : 0) != 0;
+    params.mReadHedgeDelayMs = mConfig.getValue(
+        "client.readHedgeDelayMs", params.mReadHedgeDelayMs);
+    params.mReadHedgePercentile = mConfig.getValue(
+        "client.readHedgePercentile", params.mReadHedgePercentile);
+    params.mWriteAllocateAheadFlag = mConfig.getValue(
+        "client.writeAllocateAhead",
+        params.mWriteAllocateAheadFlag ? 1 : 0) != 0;
     mProtocolWorker = new KfsProtocolWorker(
         mMetaServerLoc.hostname,
         mMetaServerLoc.port,
@@ -5272,6 +5483,9 @@ KfsClientImpl::DoMetaOpWithRetry(KfsOp* op)
 void
 KfsClientImpl::ExecuteMeta(KfsOp& op)
 {
+    if (mTrackDirChangesFlag) {
+        op.dirChangeSeq = mDirChangeSeq;
+    }
     if (mMetaServer) {
         mMetaServer->GetNetManager().UpdateTimeNow();
         if (! mMetaServer->Enqueue(&op, this)) {
@@ -5292,6 +5506,9 @@ KfsClientImpl::ExecuteMeta(KfsOp& op)
         StartProtocolWorker();
         mProtocolWorker->ExecuteMeta(op);
     }
+    if (0 <= op.dirChangeSeq) {
+        UpdateDirChanges(op);
+    }
     KFS_LOG_STREAM_DEBUG <<
         "meta op done:" <<
         " seq: "    << op.seq <<
@@ -5302,6 +5519,51 @@ KfsClientImpl::ExecuteMeta(KfsOp& op)
     KFS_LOG_EOM;
 }
 
+///
+/// Apply directory changes piggybacked by the meta server to the response.
+/// The changes only invalidate cached attributes earlier, the attribute max
+/// age is still bounded by the re-validate time, as the file size and
+/// modification time changes caused by writes are not reported.
+///
+void
+KfsClientImpl::UpdateDirChanges(const KfsOp& op)
+{
+    if (op.dirChangeCurSeq < 0) {
+        // Meta server does not support directory change tracking.
+        return;
+    }
+    if (op.dirChangeCurSeq < mDirChangeSeq) {
+        // Response to a request that was sent before the most recent one.
+        return;
+    }
+    if (! op.dirChanges.empty()) {
+        const char*       ptr = op.dirChanges.c_str();
+        const char* const end = ptr + op.dirChanges.size();
+        if (*ptr == '*') {
+            InvalidateAllCachedAttrs();
+        }
+        while (ptr < end && *ptr != '*') {
+            kfsFileId_t dirFid = -1;
+            if (! DecIntParser::Parse(ptr, end - ptr, dirFid)) {
+                InvalidateAllCachedAttrs();
+                break;
+            }
+            for (FidNameToFAttrMap::const_iterator it =
+                        mFidNameToFAttrMap.lower_bound(
+                            make_pair(dirFid, string()));
+                    it != mFidNameToFAttrMap.end() &&
+                        it->first.first == dirFid;
+                    ++it) {
+                it->second->generation = mFAttrCacheGeneration - 1;
+            }
+            while (ptr < end && (*ptr & 0xFF) == ',') {
+                ++ptr;
+            }
+        }
+    }
+    mDirChangeSeq = op.dirChangeCurSeq;
+}
+
 void
 KfsClientImpl::DoChunkServerOp(const ServerLocation& loc, KfsOp& op)
 {
@@ -7460,5 +7722,36 @@ KfsClientImpl::GetStats()
     return ret;
 }
 
+int
+KfsClientImpl::GetFsSpace(int64_t& totalSpace, int64_t& usedSpace,
+    int64_t& freeSpace)
+{
+    QCStMutexLocker l(mMutex);
+    // Meta server ping is relatively expensive, and statfs can be invoked
+    // frequently, for example by df and file managers. Use the cached
+    // result if it is recent enough.
+    const time_t now = time(0);
+    if (mFsTotalSpace < 0 || now < mFsSpaceUpdateTime ||
+            mFsSpaceUpdateTime + mFsSpaceCacheTime < now) {
+        MetaPingOp op(0);
+        DoMetaOpWithRetry(&op);
+        if (op.status < 0) {
+            return op.status;
+        }
+        if (op.totalSpace < 0 || op.usedSpace < 0) {
+            return -EIO;
+        }
+        mFsTotalSpace      = op.totalSpace;
+        mFsUsedSpace       = op.usedSpace;
+        mFsFreeSpace       = 0 <= op.freeSpace ? op.freeSpace :
+            max(int64_t(0), op.totalSpace - op.usedSpace);
+        mFsSpaceUpdateTime = now;
+    }
+    totalSpace = mFsTotalSpace;
+    usedSpace  = mFsUsedSpace;
+    freeSpace  = mFsFreeSpace;
+    return 0;
+}
+
 } // client
 } // KFS
@@ -73,6 +73,33 @@ public:
         ErrorHandler(const ErrorHandler&) {}
         ErrorHandler& operator=(const ErrorHandler&) { return *this; }
     };
+    /// Directory listing position used by OpenDir() and NextEntries().
+    /// Only the resume point is kept, thus the memory footprint does not
+    /// depend on the directory size.
+    class DirCursor
+    {
+    public:
+        DirCursor()
+            : mPathName(),
+              mDirFid(-1),
+              mFnameStart(),
+              mPrevNames(),
+              mComputeFilesizeFlag(true),
+              mFileIdAndTypeOnlyFlag(false),
+              mDoneFlag(true)
+            {}
+        bool IsDone() const
+            { return mDoneFlag; }
+    private:
+        string         mPathName;
+        kfsFileId_t    mDirFid;
+        string         mFnameStart;
+        vector<string> mPrevNames; // Previous response names, in order.
+        bool           mComputeFilesizeFlag;
+        bool           mFileIdAndTypeOnlyFlag;
+        bool           mDoneFlag;
+        friend class client::KfsClientImpl;
+    };
 
     KfsClient(client::KfsNetClient* metaServer = 0);
     ~KfsClient();
@@ -161,6 +188,28 @@ public:
     ///
     int OpenDirectory(const char *pathname);
 
+    ///
+    /// Start paged directory listing. Unlike ReaddirPlus() the entries are
+    /// returned by NextEntries() one meta server response at a time, in the
+    /// meta server order, i.e. not sorted.
+    /// @param[in] pathname The full pathname such as /.../dir
+    /// @param[out] cursor  The listing position
+    /// @retval 0 on success; -errno otherwise
+    ///
+    int OpenDir(const char *pathname, DirCursor& cursor,
+        bool computeFilesize = true, bool fileIdAndTypeOnly = false);
+
+    ///
+    /// Retrieve the next batch of directory entries and their attributes.
+    /// @param[in] cursor   The listing position returned by OpenDir()
+    /// @param[out] result  The entries
+    /// @retval number of entries, 0 at the end of the directory; -errno
+    /// otherwise. -EAGAIN means that the directory has changed in a way that
+    /// prevents the listing from resuming; the listing can be restarted with
+    /// OpenDir()
+    ///
+    int NextEntries(DirCursor& cursor, vector<KfsFileAttr>& result);
+
     ///
     /// Stat a file and get its attributes.
     /// @param[in] pathname The full pathname such as /.../foo
@@ -725,6 +774,15 @@ public:
         uint64_t&   outIssuedTime,
         uint32_t&   outValidForSec);
     Properties* GetStats(); // DisposeProperties() must be invoked to cleanup.
+    ///
+    /// Retrieve file system space usage from the meta server, for statfs().
+    /// @param[out] totalSpace Total chunk servers space in bytes
+    /// @param[out] usedSpace  Used chunk servers space in bytes
+    /// @param[out] freeSpace  Space available for new chunks in bytes
+    /// @retval 0 on success; -errno otherwise
+    ///
+    int GetFsSpace(int64_t& totalSpace, int64_t& usedSpace,
+        int64_t& freeSpace);
     static Properties* CreateProperties();
     static void DisposeProperties(
         Properties* props);
@@ -207,6 +207,7 @@ struct FileTableEntry {
     unsigned int         instance;
     int64_t              pending;
     vector<KfsFileAttr>* dirEntries;
+    KfsClient::DirCursor* dirCursor;
     int                  ioBufferSize;
     ReadBuffer           buffer;
     ReadRequest*         mReadQueue[1];
@@ -227,12 +228,14 @@ struct FileTableEntry {
         instance(instance),
         pending(0),
         dirEntries(0),
+        dirCursor(0),
         ioBufferSize(0),
         buffer()
         { mReadQueue[0] = 0; }
     ~FileTableEntry()
     {
         delete dirEntries;
+        delete dirCursor;
     }
 };
 
@@ -336,6 +339,11 @@ public:
     ///
     int OpenDirectory(const char *pathname);
 
+    int OpenDir(const char *pathname, KfsClient::DirCursor& cursor,
+        bool computeFilesize = true, bool fileIdAndTypeOnly = false);
+    int NextEntries(KfsClient::DirCursor& cursor,
+        vector<KfsFileAttr>& result);
+
     ///
     /// Stat a file and get its attributes.
     /// @param[in] pathname The full pathname such as /.../foo
@@ -643,6 +651,8 @@ public:
         uint64_t&   outIssuedTime,
         uint32_t&   outValidForSec);
     Properties* GetStats();
+    int GetFsSpace(int64_t& totalSpace, int64_t& usedSpace,
+        int64_t& freeSpace);
 
 private:
      /// Maximum # of files a client can have open minus 1.
@@ -771,6 +781,13 @@ private:
     int                            mFileAttributeRevalidateTime;
     unsigned int                   mFileAttributeRevalidateScan;
     unsigned int                   mFAttrCacheGeneration;
+    bool                           mTrackDirChangesFlag;
+    int64_t                        mDirChangeSeq;
+    int                            mFsSpaceCacheTime;
+    time_t                         mFsSpaceUpdateTime;
+    int64_t                        mFsTotalSpace;
+    int64_t                        mFsUsedSpace;
+    int64_t                        mFsFreeSpace;
     TmpPath                        mTmpPath;
     string                         mTmpAbsPathStr;
     Path                           mTmpAbsPath;
@@ -927,6 +944,7 @@ private:
     /// dies in the middle, retry the op a few times before giving up.
     void DoMetaOpWithRetry(KfsOp *op);
     void ExecuteMeta(KfsOp& op);
+    void UpdateDirChanges(const KfsOp& op);
     void DoChunkServerOp(const ServerLocation& loc, KfsOp& op);
     void DoServerOp(KfsNetClient& server, const ServerLocation& loc, KfsOp& op);
 
@@ -980,6 +998,8 @@ private:
         vector<KfsFileAttr> &result,
         bool computeFilesize = true, bool updateClientCache = true,
         bool fileIdAndTypeOnly = false);
+    int NextEntriesSelf(KfsClient::DirCursor& cursor,
+        vector<KfsFileAttr>& result);
 
     int Rmdirs(const string &parentDir, kfsFileId_t parentFid, const string &dirname, kfsFileId_t dirFid);
     int Remove(const string &parentDir, kfsFileId_t parentFid, const string &entryName);
@@ -81,6 +81,9 @@ public:
         if (op.maxWaitMillisec > 0) {
             os << "Max-wait-ms: " << op.maxWaitMillisec << "\r\n";
         }
+        if (0 <= op.dirChangeSeq) {
+            os << "Dir-change-seq: " << op.dirChangeSeq << "\r\n";
+        }
         return os;
     }
 private:
@@ -516,6 +519,7 @@ ReadOp::Request(ostream &os)
         "Chunk-version: " << chunkVersion      << "\r\n"
         "Offset: "        << offset            << "\r\n"
         "Num-bytes: "     << numBytes          << "\r\n"
+        "Checksums-hex: 1\r\n"
         << Access()
     ;
     if (skipVerifyDiskChecksumFlag) {
@@ -847,6 +851,10 @@ KfsOp::ParseResponseHeader(const Properties& prop)
     }
     contentLength = prop.getValue("Content-length", 0);
     statusMsg = prop.getValue("Status-message", string());
+    if (0 <= dirChangeSeq) {
+        dirChangeCurSeq = prop.getValue("Dir-change-seq", int64_t(-1));
+        dirChanges      = prop.getValue("Dir-changes",    string());
+    }
     ParseResponseHeaderSelf(prop);
 }
 
@@ -1223,17 +1231,26 @@ SizeOp::ParseResponseHeaderSelf(const Properties &prop)
 void
 ReadOp::ParseResponseHeaderSelf(const Properties &prop)
 {
-    string checksumStr;
-    uint32_t nentries;
-
-    nentries = prop.getValue("Checksum-entries", 0);
-    checksumStr = prop.getValue("Checksums", "");
+    const uint32_t nentries = prop.getValue("Checksum-entries", 0);
     diskIOTime = prop.getValue("DiskIOtime", 0.0);
     skipVerifyDiskChecksumFlag =
         skipVerifyDiskChecksumFlag &&
         prop.getValue("Skip-Disk-Chksum", 0) != 0;
-    istringstream ist(checksumStr);
     checksums.clear();
+    if (nentries <= 0) {
+        return;
+    }
+    const Properties::String* const hcks = prop.getValue("Checksums-hex");
+    if (hcks) {
+        if (! HexToChecksums(hcks->GetPtr(), hcks->GetSize(), nentries,
+                checksums)) {
+            checksums.clear();
+            status    = -EINVAL;
+            statusMsg = "invalid checksums";
+        }
+        return;
+    }
+    istringstream ist(prop.getValue("Checksums", string()));
     for (uint32_t i = 0; i < nentries; i++) {
         uint32_t cksum;
         ist >> cksum;
@@ -1481,6 +1498,9 @@ void
 MetaPingOp::ParseResponseHeaderSelf(const Properties& prop)
 {
     const char delim = '\t';
+    totalSpace = prop.getValue("Total-space", int64_t(-1));
+    usedSpace  = prop.getValue("Used-space",  int64_t(-1));
+    freeSpace  = prop.getValue("Free-space",  int64_t(-1));
     string serv  = prop.getValue("Servers", "");
     size_t start = serv.find_first_of("s=");
     if (start == string::npos) {
@@ -147,6 +147,11 @@ struct KfsOp {
     size_t   contentBufLen;
     char*    contentBuf;
     string   statusMsg; // optional, mostly for debugging
+    // Meta server directory changes: the last seen sequence number sent with
+    // the request, and the current sequence and changes list returned.
+    int64_t  dirChangeSeq;
+    int64_t  dirChangeCurSeq;
+    string   dirChanges;
 
     KfsOp (KfsOp_t o, kfsSeq_t s)
         : op(o),
@@ -159,6 +164,9 @@ struct KfsOp {
           contentBufLen(0),
           contentBuf(0),
           statusMsg(),
+          dirChangeSeq(-1),
+          dirChangeCurSeq(-1),
+          dirChanges(),
           contentBufOwnerFlag(true)
         {}
     // to allow dynamic-type-casting, make the destructor virtual
@@ -1643,10 +1651,16 @@ typedef KfsOp KfsMonOp;
 struct MetaPingOp : public KfsMonOp {
     vector<string> upServers; /// result
     vector<string> downServers; /// result
+    int64_t        totalSpace;
+    int64_t        usedSpace;
+    int64_t        freeSpace;
     MetaPingOp(kfsSeq_t s)
         : KfsMonOp(CMD_META_PING, s),
           upServers(),
-          downServers()
+          downServers(),
+          totalSpace(-1),
+          usedSpace(-1),
+          freeSpace(-1)
         {}
     virtual void Request(ostream& os);
     virtual void ParseResponseHeaderSelf(const Properties& prop);
@@ -128,6 +128,9 @@ public:
           mMaxReadSize(inParameters.mMaxReadSize),
           mReadLeaseRetryTimeout(inParameters.mReadLeaseRetryTimeout),
           mLeaseWaitTimeout(inParameters.mLeaseWaitTimeout),
+          mReadHedgeDelayMs(inParameters.mReadHedgeDelayMs),
+          mReadHedgePercentile(inParameters.mReadHedgePercentile),
+          mWriteAllocateAheadFlag(inParameters.mWriteAllocateAheadFlag),
           mChunkServerInitialSeqNum(
             inParameters.mChunkServerInitialSeqNum > 0 ?
                 inParameters.mChunkServerInitialSeqNum :
@@ -1113,7 +1116,8 @@ private:
                 min(max(4 << 20, inOwner.mMaxWriteSize),
                     max(inOwner.mMaxWriteSize, inMaxWriteSize)),
                 inLogPrefixPtr,
-                inOwner.mChunkServerInitialSeqNum
+                inOwner.mChunkServerInitialSeqNum,
+                inOwner.mWriteAllocateAheadFlag
               ),
               mCurRequestPtr(0)
             { WorkQueue::Init(mWorkQueue); }
@@ -1412,7 +1416,9 @@ private:
                 inOwner.mLeaseWaitTimeout,
                 inLogPrefixPtr,
                 inOwner.mChunkServerInitialSeqNum,
-                inOwner.mClientPoolPtr),
+                inOwner.mClientPoolPtr,
+                inOwner.mReadHedgeDelayMs,
+                inOwner.mReadHedgePercentile),
               mCurRequestPtr(0),
               mAsyncReadStatus(0),
               mAsyncReadDoneCount(0)
@@ -1655,6 +1661,9 @@ private:
     const int            mMaxReadSize;
     const int            mReadLeaseRetryTimeout;
     const int            mLeaseWaitTimeout;
+    const int            mReadHedgeDelayMs;
+    const int            mReadHedgePercentile;
+    const bool           mWriteAllocateAheadFlag;
     int64_t              mChunkServerInitialSeqNum;
     DoNotDeallocate      mDoNotDeallocate;
     StopRequest          mStopRequest;
@@ -1885,6 +1894,12 @@ private:
         theEnumerator("Sockets",       globals().ctrOpenNetFds.GetValue());
         theEnumerator("BytesSent",     globals().ctrNetBytesWritten.GetValue());
         theEnumerator("BytesReceived", globals().ctrNetBytesRead.GetValue());
+        theEnumerator.SetPrefix("Network.Ssl.");
+        theEnumerator("Handshakes",    globals().ctrSslHandshakes.GetValue());
+        theEnumerator("Resumed",
+            globals().ctrSslSessionsResumed.GetValue());
+        theEnumerator("BytesSent",     globals().ctrSslBytesWritten.GetValue());
+        theEnumerator("BytesReceived", globals().ctrSslBytesRead.GetValue());
         return theRet;
     }
 private:
@@ -208,7 +208,10 @@ public:
             int                inLeaseWaitTimeout            = 900,
             int                inMaxMetaServerContentLength  = 1 << 20,
             ClientAuthContext* inAuthContextPtr              = 0,
-            bool               inUseClientPoolFlag           = false)
+            bool               inUseClientPoolFlag           = false,
+            int                inReadHedgeDelayMs            = 0,
+            int                inReadHedgePercentile         = 95,
+            bool               inWriteAllocateAheadFlag      = false)
             : mMetaMaxRetryCount(inMetaMaxRetryCount),
               mMetaTimeSecBetweenRetries(inMetaTimeSecBetweenRetries),
               mMetaOpTimeoutSec(inMetaOpTimeoutSec),
@@ -232,7 +235,10 @@ public:
               mLeaseWaitTimeout(inLeaseWaitTimeout),
               mMaxMetaServerContentLength(inMaxMetaServerContentLength),
               mAuthContextPtr(inAuthContextPtr),
-              mUseClientPoolFlag(inUseClientPoolFlag)
+              mUseClientPoolFlag(inUseClientPoolFlag),
+              mReadHedgeDelayMs(inReadHedgeDelayMs),
+              mReadHedgePercentile(inReadHedgePercentile),
+              mWriteAllocateAheadFlag(inWriteAllocateAheadFlag)
             {}
             int                 mMetaMaxRetryCount;
             int                 mMetaTimeSecBetweenRetries;
@@ -258,6 +264,9 @@ public:
             int                 mMaxMetaServerContentLength;
             ClientAuthContext*  mAuthContextPtr;
             bool                mUseClientPoolFlag;
+            int                 mReadHedgeDelayMs;
+            int                 mReadHedgePercentile;
+            bool                mWriteAllocateAheadFlag;
     };
     KfsProtocolWorker(
         std::string       inMetaHost,
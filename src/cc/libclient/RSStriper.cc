@@ -32,6 +32,7 @@
 
 #include "common/MsgLogger.h"
 #include "common/StBuffer.h"
+#include "common/time.h"
 
 #include "qcdio/qcdebug.h"
 #include "qcdio/QCDLList.h"
@@ -798,6 +799,7 @@ private:
             (int)((mOffset - theStrideHead) - mRecoveryEndPos);
         const int theSize       = theTotalSize / mStripeCount;
         QCASSERT(theSize * mStripeCount == theTotalSize);
+        const int64_t theStartTime = microseconds();
         Offset thePendingCount = 0;
         for (int i = mStripeCount;
                 i < mStripeCount + mRecoveryStripeCount;
@@ -919,6 +921,8 @@ private:
                 ));
             }
         }
+        ParityDone(int64_t(theSize) * mRecoveryStripeCount,
+            microseconds() - theStartTime);
         mRecoveryEndPos += theTotalSize;
         if (mLastPartialFlushPos + mStrideSize > mRecoveryEndPos) {
             // The partial stride was previously written / flushed.
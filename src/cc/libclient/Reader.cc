@@ -74,6 +74,13 @@ class Reader::Impl : public QCRefCountedObj
 public:
     typedef QCRefCountedObj::StRef StRef;
 
+    enum
+    {
+        kReadLatencyBucketCount    = 24,
+        kReadLatencyMaxCount       = 1 << 12,
+        kReadLatencyMinSampleCount = 64
+    };
+
     enum
     {
         kErrorNone           = 0,
@@ -102,7 +109,9 @@ public:
         int         inLeaseWaitTimeout,
         string      inLogPrefix,
         int64_t     inChunkServerInitialSeqNum,
-        ClientPool* inClientPoolPtr)
+        ClientPool* inClientPoolPtr,
+        int         inHedgeDelayMs,
+        int         inHedgePercentile)
         : QCRefCountedObj(),
           mOuter(inOuter),
           mMetaServer(inMetaServer),
@@ -131,8 +140,16 @@ public:
           mNetManager(mMetaServer.GetNetManager()),
           mStriperPtr(0),
           mCompletionDepthCount(0),
-          mReplicaCount(-1)
-        { Readers::Init(mReaders); }
+          mReplicaCount(-1),
+          mHedgeDelayMs(inHedgeDelayMs),
+          mHedgePercentile(max(0, min(100, inHedgePercentile))),
+          mReadLatencyCount(0)
+    {
+        Readers::Init(mReaders);
+        for (int i = 0; i < kReadLatencyBucketCount; i++) {
+            mReadLatency[i] = 0;
+        }
+    }
     int Open(
         kfsFileId_t inFileId,
         const char* inFileNamePtr,
@@ -335,6 +352,7 @@ private:
             typedef vector<RequestEntry> Requests;
 
             time_t    mOpStartTime;
+            int64_t   mOpStartTimeMs;
             IOBuffer  mBuffer;
             IOBuffer  mTmpBuffer;
             RequestId mRequestId;
@@ -343,6 +361,7 @@ private:
             bool      mRetryIfFailsFlag;
             bool      mFailShortReadFlag;
             bool      mCancelFlag;
+            bool      mHedgeWonFlag;
 
             ReadOp(
                 int       inOpSize,
@@ -353,6 +372,7 @@ private:
                 bool      inFailShortReadFlag)
                 : KFS::client::ReadOp(-1, -1, -1),
                   mOpStartTime(0),
+                  mOpStartTimeMs(0),
                   mBuffer(),
                   mTmpBuffer(),
                   mRequestId(inRequestId),
@@ -360,7 +380,8 @@ private:
                   mRequests(),
                   mRetryIfFailsFlag(inRetryIfFailsFlag),
                   mFailShortReadFlag(inFailShortReadFlag),
-                  mCancelFlag(false)
+                  mCancelFlag(false),
+                  mHedgeWonFlag(false)
             {
                 Queue::Init(*this);
                 numBytes                   = inOpSize;
@@ -386,6 +407,48 @@ private:
             ReadOp& operator=(
                 const ReadOp& inOp);
         };
+        // Speculative read of the oldest in flight read op range from another
+        // replica.
+        class HedgeOp : public KFS::client::ReadOp
+        {
+        public:
+            ChunkReader::ReadOp* mOrigPtr;
+            IOBuffer             mBuffer;
+
+            HedgeOp()
+                : KFS::client::ReadOp(-1, -1, -1),
+                  mOrigPtr(0),
+                  mBuffer()
+                {}
+        private:
+            HedgeOp(
+                const HedgeOp& inOp);
+            HedgeOp& operator=(
+                const HedgeOp& inOp);
+        };
+        class HedgeTimer : public KfsCallbackObj
+        {
+        public:
+            HedgeTimer(
+                ChunkReader& inReader)
+                : KfsCallbackObj(),
+                  mReader(inReader)
+                { SET_HANDLER(this, &HedgeTimer::Timeout); }
+            int Timeout(
+                int   /* inType */,
+                void* /* inDataPtr */)
+            {
+                mReader.HedgeTimeout();
+                return 0;
+            }
+        private:
+            ChunkReader& mReader;
+        private:
+            HedgeTimer(
+                const HedgeTimer& inTimer);
+            HedgeTimer& operator=(
+                const HedgeTimer& inTimer);
+        };
 
         ChunkReader(
             Impl&         inOuter,
@@ -445,7 +508,12 @@ private:
               mLogPrefix(inLogPrefix),
               mOpsNoRetryCount(0),
               mDeletedFlagPtr(0),
-              mRunningCompletionPtr(0)
+              mRunningCompletionPtr(0),
+              mHedgeOp(),
+              mHedgeTimerObj(*this),
+              mHedgeTimer(inOuter.mNetManager, mHedgeTimerObj),
+              mHedgeChunkServerPtr(0),
+              mOwnHedgeChunkServerPtr(0)
         {
             Queue::Init(mPendingQueue);
             Queue::Init(mInFlightQueue);
@@ -467,6 +535,11 @@ private:
             ChunkServer::Stats theStats;
             mChunkServer.GetStats(theStats);
             mOuter.mChunkServersStats.Add(theStats);
+            if (mOwnHedgeChunkServerPtr) {
+                mOwnHedgeChunkServerPtr->GetStats(theStats);
+                mOuter.mChunkServersStats.Add(theStats);
+                delete mOwnHedgeChunkServerPtr;
+            }
             Readers::Remove(mOuter.mReaders, *this);
             if (mDeletedFlagPtr) {
                 *mDeletedFlagPtr = true;
@@ -801,6 +874,11 @@ private:
         int                  mOpsNoRetryCount;
         bool*                mDeletedFlagPtr;
         StRunningCompletion* mRunningCompletionPtr;
+        HedgeOp              mHedgeOp;
+        HedgeTimer           mHedgeTimerObj;
+        NetManager::TimerMs  mHedgeTimer;
+        ChunkServer*         mHedgeChunkServerPtr;
+        ChunkServer*         mOwnHedgeChunkServerPtr;
         ReadOp*              mPendingQueue[1];
         ReadOp*              mInFlightQueue[1];
         ReadOp*              mCompletionQueue[1];
@@ -1293,8 +1371,10 @@ private:
                 return;
             }
             inReadOp.access = mSizeOp.access;
+            inReadOp.mOpStartTimeMs = ITimeout::NowMs();
             mOuter.mStats.mOpsReadCount++;
             Enqueue(inReadOp, &inReadOp.mTmpBuffer);
+            ScheduleHedge();
         }
         void Done(
             ReadOp&   inOp,
@@ -1305,16 +1385,30 @@ private:
                 inBufferPtr == &inOp.mTmpBuffer &&
                 Queue::IsInList(mInFlightQueue, inOp)
             );
+            bool theCanceledFlag = inCanceledFlag;
+            bool theVerifiedFlag = false;
+            if (inOp.mHedgeWonFlag) {
+                // The primary read was canceled, use hedged read result. The
+                // hedged read checksums were verified prior to the cancel.
+                inOp.mHedgeWonFlag = false;
+                TakeHedgeResult(inOp);
+                theCanceledFlag = false;
+                theVerifiedFlag = true;
+            } else if (mHedgeOp.mOrigPtr == &inOp) {
+                CancelHedge();
+            }
             if (inOp.status == kErrorNoEntry &&
                     mGetAllocOp.status != kErrorNoEntry) {
                 inOp.status = kErrorIO;
             }
-            if (inCanceledFlag || inOp.status < 0 || ! VerifyChecksum(inOp) ||
+            if (theCanceledFlag || inOp.status < 0 ||
+                    (! theVerifiedFlag &&
+                        ! VerifyChecksum(inOp, inOp.mTmpBuffer)) ||
                     ! VerifyRead(inOp)) {
                 Queue::Remove(mInFlightQueue, inOp);
                 Queue::PushBack(mPendingQueue, inOp);
                 inOp.mTmpBuffer.Clear();
-                if (inCanceledFlag) {
+                if (theCanceledFlag) {
                     return;
                 }
                 Monitor::ReportError(
@@ -1342,6 +1436,12 @@ private:
             );
             mOuter.mStats.mReadCount++;
             mOuter.mStats.mReadByteCount += theDoneCount;
+            if (! inCanceledFlag) {
+                // Hedged read win latency is accounted by the hedged read
+                // completion.
+                mOuter.UpdateReadLatency(
+                    ITimeout::NowMs() - inOp.mOpStartTimeMs);
+            }
             if (theDoneCount < inOp.mTmpBuffer.BytesConsumable()) {
                 // Move available space, if any, to the end of the short read.
                 IOBuffer theBuf;
@@ -1378,6 +1478,7 @@ private:
                 mOpsNoRetryCount--;
             }
             inOp.Delete(inQueuePtr);
+            ScheduleHedge();
             if (theCompl.mRequests.empty()) {
                 if (! ReportCompletion(
                         theLastError,
@@ -1414,8 +1515,240 @@ private:
             }
             return true;
         }
-        bool VerifyChecksum(
+        void ScheduleHedge()
+        {
+            if (mHedgeOp.mOrigPtr || mHedgeTimer.IsScheduled() ||
+                    mGetAllocOp.chunkServers.size() <= 1) {
+                return;
+            }
+            const ReadOp* const theOpPtr = Queue::Front(mInFlightQueue);
+            if (! theOpPtr) {
+                return;
+            }
+            const int theDelayMs = mOuter.GetHedgeDelayMs();
+            if (theDelayMs < 0) {
+                return;
+            }
+            mHedgeTimer.Schedule((int)max(int64_t(0),
+                theOpPtr->mOpStartTimeMs + theDelayMs - ITimeout::NowMs()));
+        }
+        void HedgeTimeout()
+        {
+            ReadOp* const theOpPtr = Queue::Front(mInFlightQueue);
+            if (mHedgeOp.mOrigPtr || ! theOpPtr || mErrorCode != 0 ||
+                    mSleepingFlag || ! mChunkServerSetFlag || mNoCSAccessFlag ||
+                    mGetAllocOp.chunkServers.size() <= 1 ||
+                    theOpPtr->offset >= mSizeOp.size) {
+                return;
+            }
+            const int theDelayMs = mOuter.GetHedgeDelayMs();
+            if (theDelayMs < 0) {
+                return;
+            }
+            const int64_t theRemMs =
+                theOpPtr->mOpStartTimeMs + theDelayMs - ITimeout::NowMs();
+            if (0 < theRemMs) {
+                mHedgeTimer.Schedule((int)theRemMs);
+                return;
+            }
+            const ServerLocation& theLocation = mGetAllocOp.chunkServers[
+                (mChunkServerIdx + 1) % mGetAllocOp.chunkServers.size()];
+            Reset(mHedgeOp);
+            ChunkServer* const theServerPtr =
+                GetHedgeChunkServer(theLocation, mHedgeOp.access);
+            if (! theServerPtr) {
+                return;
+            }
+            mHedgeOp.chunkId                    = theOpPtr->chunkId;
+            mHedgeOp.chunkVersion               = theOpPtr->chunkVersion;
+            mHedgeOp.offset                     = theOpPtr->offset;
+            mHedgeOp.numBytes                   = theOpPtr->numBytes;
+            mHedgeOp.skipVerifyDiskChecksumFlag =
+                theOpPtr->skipVerifyDiskChecksumFlag;
+            mHedgeOp.checksums.clear();
+            mHedgeOp.mBuffer.Clear();
+            mHedgeOp.mOrigPtr    = theOpPtr;
+            mHedgeChunkServerPtr = theServerPtr;
+            mOuter.mStats.mReadHedgeCount++;
+            mOuter.mStats.mChunkOpsQueuedCount++;
+            KFS_LOG_STREAM_DEBUG << mLogPrefix <<
+                "hedge: " << theLocation <<
+                " after: " << (ITimeout::NowMs() - theOpPtr->mOpStartTimeMs) <<
+                " ms. delay: " << theDelayMs <<
+                " " << mHedgeOp.Show() <<
+            KFS_LOG_EOM;
+            if (! theServerPtr->Enqueue(&mHedgeOp, this, &mHedgeOp.mBuffer) &&
+                    mHedgeOp.mOrigPtr) {
+                mHedgeOp.mOrigPtr    = 0;
+                mHedgeChunkServerPtr = 0;
+                mHedgeOp.mBuffer.Clear();
+            }
+        }
+        ChunkServer* GetHedgeChunkServer(
+            const ServerLocation& inLocation,
+            string&               outAccess)
+        {
+            outAccess.clear();
+            ChunkServer* theServerPtr;
+            if (mOuter.mClientPoolPtr) {
+                theServerPtr = &mOuter.mClientPoolPtr->Get(inLocation);
+            } else {
+                if (! mOwnHedgeChunkServerPtr) {
+                    mOwnHedgeChunkServerPtr = new ChunkServer(
+                        mOuter.mNetManager,
+                        string(), -1, // host, port
+                        0, // inMaxRetryCount
+                        0, // inTimeSecBetweenRetries,
+                        mOuter.mOpTimeoutSec,
+                        mOuter.mIdleTimeoutSec,
+                        mOuter.mChunkServerInitialSeqNum,
+                        (mLogPrefix + "H ").c_str(),
+                        false, // inResetConnectionOnOpTimeoutFlag
+                        int(min(
+                            int64_t(mOuter.mMaxReadSize) + (64 << 10),
+                            int64_t(std::numeric_limits<int>::max())
+                        ))
+                    );
+                    mOwnHedgeChunkServerPtr->SetRetryConnectOnly(true);
+                }
+                theServerPtr = mOwnHedgeChunkServerPtr;
+            }
+            if (mChunkServerAccess.IsEmpty()) {
+                theServerPtr->SetKey(0, 0, 0, 0);
+                theServerPtr->SetAuthContext(0);
+            } else {
+                CryptoKeys::Key theKey;
+                const ChunkServerAccess::Entry* const thePtr =
+                    mChunkServerAccess.Get(
+                        inLocation,
+                        mGetAllocOp.chunkId,
+                        theKey
+                    );
+                if (! thePtr) {
+                    return 0;
+                }
+                if (mChunkAccess.IsEmpty()) {
+                    outAccess.assign(
+                        thePtr->chunkAccess.mPtr,
+                        thePtr->chunkAccess.mLen
+                    );
+                } else {
+                    outAccess = mChunkAccess.GetChunkAccess(
+                        inLocation, mGetAllocOp.chunkId);
+                }
+                if (outAccess.empty()) {
+                    return 0;
+                }
+                theServerPtr->SetKey(
+                    thePtr->chunkServerAccessId.mPtr,
+                    thePtr->chunkServerAccessId.mLen,
+                    theKey.GetPtr(),
+                    theKey.GetSize()
+                );
+                if (! theServerPtr->GetAuthContext()) {
+                    theServerPtr->SetAuthContext(
+                        mOuter.mMetaServer.GetAuthContext());
+                }
+            }
+            theServerPtr->SetShutdownSsl(GetChunkServer().IsShutdownSsl());
+            if (theServerPtr == mOwnHedgeChunkServerPtr) {
+                theServerPtr->SetServer(inLocation);
+            }
+            return theServerPtr;
+        }
+        void Done(
+            HedgeOp&  inOp,
+            bool      inCanceledFlag,
+            IOBuffer* inBufferPtr)
+        {
+            QCASSERT(&mHedgeOp == &inOp && inBufferPtr == &inOp.mBuffer);
+            ReadOp* const theOrigPtr = inOp.mOrigPtr;
+            inOp.mOrigPtr        = 0;
+            mHedgeChunkServerPtr = 0;
+            if (inCanceledFlag || ! theOrigPtr) {
+                inOp.mBuffer.Clear();
+                return;
+            }
+            if (inOp.status < 0 ||
+                    inOp.numBytes < inOp.contentLength ||
+                    (inOp.contentLength < inOp.numBytes &&
+                        inOp.offset + (Offset)inOp.numBytes <= mSizeOp.size) ||
+                    ! Queue::IsInList(mInFlightQueue, *theOrigPtr)) {
+                // Let the primary read complete, do not attempt to handle
+                // hedged read errors.
+                KFS_LOG_STREAM_DEBUG << mLogPrefix <<
+                    "hedge: " << inOp.Show() <<
+                    " status: " << inOp.status <<
+                    " "         << inOp.statusMsg <<
+                    " length: " << inOp.contentLength <<
+                    " ignored" <<
+                KFS_LOG_EOM;
+                inOp.mBuffer.Clear();
+                ScheduleHedge();
+                return;
+            }
+            // Verify the hedged read prior to canceling the primary, and let
+            // the primary complete if verification fails. Do not re-schedule
+            // hedge in this case, as it would be sent to the same replica.
+            if (! VerifyChecksum(inOp, inOp.mBuffer)) {
+                KFS_LOG_STREAM_ERROR << mLogPrefix <<
+                    "hedge: " << inOp.Show() <<
+                    " "       << inOp.statusMsg <<
+                    " ignored" <<
+                KFS_LOG_EOM;
+                inOp.mBuffer.Clear();
+                return;
+            }
+            mOuter.mStats.mReadHedgeWinCount++;
+            // Account the latency that the hedged read completed the primary
+            // with. Otherwise the slow reads, where the hedged read wins,
+            // would be excluded from the latency histogram, and would bias
+            // the hedge delay percentile low.
+            mOuter.UpdateReadLatency(
+                ITimeout::NowMs() - theOrigPtr->mOpStartTimeMs);
+            // Cancel invokes read op completion, which takes over the hedged
+            // read result.
+            theOrigPtr->mHedgeWonFlag = true;
+            GetChunkServer().Cancel(theOrigPtr, this);
+        }
+        void TakeHedgeResult(
             ReadOp& inOp)
+        {
+            // Copy data into the caller's buffers, the read completion
+            // expects the data to be there.
+            inOp.mTmpBuffer.Clear();
+            inOp.mTmpBuffer.UseSpaceAvailable(&inOp.mBuffer, inOp.numBytes);
+            for (IOBuffer::iterator theIt = mHedgeOp.mBuffer.begin();
+                    theIt != mHedgeOp.mBuffer.end();
+                    ++theIt) {
+                inOp.mTmpBuffer.CopyIn(
+                    theIt->Consumer(), theIt->BytesConsumable());
+            }
+            mHedgeOp.mBuffer.Clear();
+            inOp.status        = mHedgeOp.status;
+            inOp.lastError     = mHedgeOp.lastError;
+            inOp.contentLength = mHedgeOp.contentLength;
+            inOp.statusMsg.swap(mHedgeOp.statusMsg);
+            inOp.checksums.swap(mHedgeOp.checksums);
+            mHedgeOp.checksums.clear();
+        }
+        void CancelHedge()
+        {
+            mHedgeTimer.Cancel();
+            if (! mHedgeOp.mOrigPtr) {
+                return;
+            }
+            mHedgeOp.mOrigPtr = 0;
+            ChunkServer* const theServerPtr = mHedgeChunkServerPtr;
+            mHedgeChunkServerPtr = 0;
+            if (theServerPtr) {
+                theServerPtr->Cancel(&mHedgeOp, this);
+            }
+            mHedgeOp.mBuffer.Clear();
+        }
+        bool VerifyChecksum(
+            KFS::client::ReadOp& inOp,
+            IOBuffer&            inBuffer)
         {
             if (inOp.contentLength <= 0 && inOp.checksums.empty()) {
                 return true;
@@ -1425,8 +1758,8 @@ private:
                     inOp.checksums.end();
                 vector<uint32_t>::const_iterator       theOpIt    =
                     inOp.checksums.begin();
-                IOBuffer::iterator const theEndIt     = inOp.mTmpBuffer.end();
-                IOBuffer::iterator       theIt        = inOp.mTmpBuffer.begin();
+                IOBuffer::iterator const theEndIt     = inBuffer.end();
+                IOBuffer::iterator       theIt        = inBuffer.begin();
                 int                      theTLen      = inOp.contentLength;
                 const char*              thePtr       = 0;
                 const char*              theEndPtr    = 0;
@@ -1496,7 +1829,7 @@ private:
                 return false;
             }
             vector<uint32_t> const theChecksums =
-                    ComputeChecksums(&inOp.mTmpBuffer, inOp.contentLength);
+                    ComputeChecksums(&inBuffer, inOp.contentLength);
             if (theChecksums == inOp.checksums) {
                 return true;
             }
@@ -1686,6 +2019,8 @@ private:
                 Done(mLeaseRelinquishOp, inCanceledFlag, inBufferPtr);
             } else if (&mSizeOp == inOpPtr) {
                 Done(mSizeOp, inCanceledFlag, inBufferPtr);
+            } else if (&mHedgeOp == inOpPtr) {
+                Done(mHedgeOp, inCanceledFlag, inBufferPtr);
             } else if (inOpPtr && inOpPtr->op == CMD_READ) {
                 Done(*static_cast<ReadOp*>(inOpPtr),
                     inCanceledFlag, inBufferPtr);
@@ -1716,6 +2051,7 @@ private:
             mLastOpPtr = 0;
             StopChunkServer();
             mChunkServerSetFlag = false;
+            CancelHedge();
             QCASSERT(Queue::IsEmpty(mInFlightQueue));
             if (mSleepingFlag) {
                 mOuter.mNetManager.UnRegisterTimeoutHandler(this);
@@ -2228,8 +2564,61 @@ private:
     Striper*            mStriperPtr;
     int                 mCompletionDepthCount;
     int                 mReplicaCount;
+    const int           mHedgeDelayMs;
+    const int           mHedgePercentile;
+    int64_t             mReadLatencyCount;
+    int64_t             mReadLatency[kReadLatencyBucketCount];
     ChunkReader*        mReaders[1];
 
+    // Read latency histogram with power of two millisecond buckets, used to
+    // compute hedged read delay. The counts are halved periodically in order
+    // to adapt to the changes in the chunk servers load.
+    void UpdateReadLatency(
+        int64_t inLatencyMs)
+    {
+        if (mHedgeDelayMs <= 0) {
+            return;
+        }
+        int     theIdx = 0;
+        int64_t theMs  = inLatencyMs;
+        while (0 < theMs && theIdx < kReadLatencyBucketCount - 1) {
+            theMs >>= 1;
+            theIdx++;
+        }
+        mReadLatency[theIdx]++;
+        if (kReadLatencyMaxCount <= ++mReadLatencyCount) {
+            mReadLatencyCount = 0;
+            for (int i = 0; i < kReadLatencyBucketCount; i++) {
+                mReadLatency[i] >>= 1;
+                mReadLatencyCount += mReadLatency[i];
+            }
+        }
+    }
+    // Returns delay after which read is re-issued to another replica, or -1
+    // if hedged reads are disabled.
+    int GetHedgeDelayMs() const
+    {
+        if (mHedgeDelayMs <= 0) {
+            return -1;
+        }
+        if (mHedgePercentile <= 0 ||
+                mReadLatencyCount < kReadLatencyMinSampleCount) {
+            return mHedgeDelayMs;
+        }
+        const int64_t theThreshold =
+            (mReadLatencyCount * mHedgePercentile + 99) / 100;
+        int64_t theCount = 0;
+        int     theIdx   = 0;
+        while (theIdx < kReadLatencyBucketCount - 1 &&
+                (theCount += mReadLatency[theIdx]) < theThreshold) {
+            theIdx++;
+        }
+        // Upper bound of the bucket.
+        const int64_t theMs = theIdx <= 0 ? int64_t(0) : (int64_t(1) << theIdx);
+        return (int)max(int64_t(mHedgeDelayMs),
+            min(theMs, int64_t(mOpTimeoutSec) * 1000));
+    }
+
     void InternalError(
             const char* inMsgPtr = 0)
     {
@@ -2697,7 +3086,9 @@ Reader::Reader(
     int                 inLeaseWaitTimeout         /* = 900 */,
     const char*         inLogPrefixPtr             /* = 0 */,
     int64_t             inChunkServerInitialSeqNum /* = 1 */,
-    ClientPool*         inClientPoolPtr            /* = 0 */)
+    ClientPool*         inClientPoolPtr            /* = 0 */,
+    int                 inHedgeDelayMs             /* = 0 */,
+    int                 inHedgePercentile          /* = 0 */)
     : mImpl(*new Reader::Impl(
         *this,
         inMetaServer,
@@ -2712,7 +3103,9 @@ Reader::Reader(
         (inLogPrefixPtr && inLogPrefixPtr[0]) ?
             (inLogPrefixPtr + string(" ")) : string(),
         inChunkServerInitialSeqNum,
-        inClientPoolPtr
+        inClientPoolPtr,
+        inHedgeDelayMs,
+        inHedgePercentile
     ))
 {
     mImpl.Ref();
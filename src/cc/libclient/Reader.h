@@ -93,7 +93,9 @@ public:
               mReadByteCount(0),
               mReadErrorsCount(0),
               mReadChecksumErrorsCount(0),
-              mReadRecoveriesCount(0)
+              mReadRecoveriesCount(0),
+              mReadHedgeCount(0),
+              mReadHedgeWinCount(0)
             {}
         void Clear()
             { *this = Stats(); }
@@ -113,6 +115,8 @@ public:
             mReadErrorsCount         += inStats.mReadErrorsCount;
             mReadChecksumErrorsCount += inStats.mReadChecksumErrorsCount;
             mReadRecoveriesCount     += inStats.mReadRecoveriesCount;
+            mReadHedgeCount          += inStats.mReadHedgeCount;
+            mReadHedgeWinCount       += inStats.mReadHedgeWinCount;
             return *this;
         }
         template<typename T>
@@ -131,6 +135,8 @@ public:
             inFunctor("ReadRecoveries",     mReadRecoveriesCount);
             inFunctor("Reads",              mReadCount);
             inFunctor("ReadBytes",          mReadByteCount);
+            inFunctor("ReadHedges",         mReadHedgeCount);
+            inFunctor("ReadHedgeWins",      mReadHedgeWinCount);
         }
         Counter mMetaOpsQueuedCount;
         Counter mMetaOpsCancelledCount;
@@ -145,6 +151,8 @@ public:
         Counter mReadErrorsCount;
         Counter mReadChecksumErrorsCount;
         Counter mReadRecoveriesCount;
+        Counter mReadHedgeCount;
+        Counter mReadHedgeWinCount;
     };
     class Striper
     {
@@ -225,6 +233,9 @@ public:
             const Striper& inStipter);
     };
     typedef KfsNetClient MetaServer;
+    // If inHedgeDelayMs is positive, read that has not completed within
+    // max(inHedgeDelayMs, inHedgePercentile of the observed read latency)
+    // is re-issued to another chunk replica, and the first response is used.
     Reader(
         MetaServer& inMetaServer,
         Completion* inCompletionPtr            = 0,
@@ -237,7 +248,9 @@ public:
         int         inLeaseWaitTimeout         = 900,
         const char* inLogPrefixPtr             = 0,
         int64_t     inChunkServerInitialSeqNum = 1,
-        ClientPool* inClientPoolPtr            = 0);
+        ClientPool* inClientPoolPtr            = 0,
+        int         inHedgeDelayMs             = 0,
+        int         inHedgePercentile          = 0);
     virtual ~Reader();
     int Open(
         kfsFileId_t inFileId,
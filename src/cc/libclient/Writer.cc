@@ -94,7 +94,8 @@ public:
         int           inIdleTimeoutSec,
         int           inMaxWriteSize,
         const string& inLogPrefix,
-        int64_t       inChunkServerInitialSeqNum)
+        int64_t       inChunkServerInitialSeqNum,
+        bool          inAllocateAheadFlag)
         : QCRefCountedObj(),
           ITimeout(),
           KfsNetClient::OpOwner(),
@@ -116,6 +117,7 @@ public:
           mMaxWriteSize(min((int)CHUNKSIZE,
             (int)((max(0, inMaxWriteSize) + CHECKSUM_BLOCKSIZE - 1) /
                 CHECKSUM_BLOCKSIZE * CHECKSUM_BLOCKSIZE))),
+          mAllocateAheadFlag(inAllocateAheadFlag),
           mReplicaCount(-1),
           mRetryCount(0),
           mFileSize(0),
@@ -515,6 +517,7 @@ private:
               mHasSubjectIdFlag(false),
               mKeepLeaseFlag(false),
               mLeaseUpdatePendingFlag(false),
+              mAllocateAheadFlag(false),
               mChunkAccess(),
               mLeaseEndTime(0),
               mLeaseExpireTime(0),
@@ -573,6 +576,7 @@ private:
                 QCRTASSERT(mAllocOp.fileOffset == inOffset - theChunkOffset);
             }
             theSize = min(theSize, (int)(kChunkSize - theChunkOffset));
+            mAllocateAheadFlag = false;
             mOuter.mStats.mWriteCount++;
             mOuter.mStats.mWriteByteCount += theSize;
             QCASSERT(theSize > 0);
@@ -738,6 +742,22 @@ private:
                 AllocateChunk();
             }
         }
+        // Allocate chunk and write id with no data pending. The chunk
+        // allocation is not retried on failure, it restarts when data arrives.
+        void AllocateAhead(
+            Offset inFileOffset)
+        {
+            QCRTASSERT(mAllocOp.fileOffset < 0 && 0 <= inFileOffset &&
+                inFileOffset % (Offset)CHUNKSIZE == 0 &&
+                Queue::IsEmpty(mPendingQueue) && ! mClosingFlag);
+            mAllocOp.fileOffset       = inFileOffset;
+            mOpenChunkBlockFileOffset = mAllocOp.fileOffset -
+                mAllocOp.fileOffset % mOuter.mOpenChunkBlockSize;
+            mAllocateAheadFlag        = true;
+            mOuter.mStats.mChunkAllocAheadCount++;
+            Reset();
+            AllocateChunk();
+        }
         void Close()
         {
             if (! mClosingFlag && IsOpen()) {
@@ -780,6 +800,10 @@ private:
             { return mErrorCode; }
         Offset GetPendingCount() const
             { return mPendingCount; }
+        bool IsChunkFull() const
+            { return ((Offset)CHUNKSIZE <= mMaxChunkPos); }
+        bool IsAllocatedAhead() const
+            { return mAllocateAheadFlag; }
         ChunkWriter* GetPrevPtr()
         {
             ChunkWriter& thePrev = ChunkWritersListOp::GetPrev(*this);
@@ -817,6 +841,7 @@ private:
         bool           mHasSubjectIdFlag;
         bool           mKeepLeaseFlag;
         bool           mLeaseUpdatePendingFlag;
+        bool           mAllocateAheadFlag;
         string         mChunkAccess;
         time_t         mLeaseEndTime;
         time_t         mLeaseExpireTime;
@@ -844,7 +869,7 @@ private:
                 mAllocOp.fileOffset >= 0 &&
                 (! Queue::IsEmpty(mPendingQueue) ||
                     (0 < mCloseOp.chunkId && mCloseOp.chunkVersion < 0) ||
-                    mKeepLeaseFlag)
+                    mKeepLeaseFlag || mAllocateAheadFlag)
             );
             Reset(mAllocOp);
             if (0 == mOuter.mReplicaCount) {
@@ -1513,6 +1538,15 @@ private:
                     "no") << " data sent" <<
                 "\nRequest:\n"            << theOStream.str() <<
             KFS_LOG_EOM;
+            if (mAllocateAheadFlag && Queue::IsEmpty(mPendingQueue)) {
+                KFS_LOG_STREAM_INFO << mLogPrefix <<
+                    "allocate ahead failed, chunk offset: " <<
+                        mAllocOp.fileOffset <<
+                KFS_LOG_EOM;
+                mAllocateAheadFlag = false;
+                Reset();
+                return;
+            }
             int       theStatus    = inOp.status;
             const int theLastError = inOp.lastError;
             if (&inOp == &mAllocOp) {
@@ -1717,6 +1751,7 @@ private:
     const int           mTimeSecBetweenRetries;
     const int           mMaxPartialBuffersCount;
     const int           mMaxWriteSize;
+    const bool          mAllocateAheadFlag;
     int                 mReplicaCount;
     int                 mRetryCount;
     Offset              mFileSize;
@@ -1939,8 +1974,43 @@ private:
         );
         if (theQueuedCount > 0) {
             mOffset += theQueuedCount;
+            const int thePrevRefCount = GetRefCount();
             StartQueuedWrite(theQueuedCount);
+            if (thePrevRefCount <= GetRefCount()) {
+                AllocateAhead();
+            }
+        }
+    }
+    // Only one chunk ahead is allocated, and only after the last byte of the
+    // current chunk is queued, as the meta server derives replicated file size
+    // from the last chunk, therefore an unused chunk past partially written
+    // chunk would change the file size.
+    void AllocateAhead()
+    {
+        if (! mAllocateAheadFlag || mStriperPtr || mReplicaCount <= 0 ||
+                mClosingFlag || mErrorCode != 0) {
+            return;
         }
+        const ChunkWriter* const theFrontPtr = Writers::Front(mWriters);
+        if (! theFrontPtr || ! theFrontPtr->IsChunkFull() ||
+                theFrontPtr->GetFileOffset() < 0) {
+            return;
+        }
+        const Offset theFileOffset =
+            theFrontPtr->GetFileOffset() + (Offset)CHUNKSIZE;
+        Writers::Iterator theIt(mWriters);
+        const ChunkWriter* thePtr;
+        while ((thePtr = theIt.Next())) {
+            if (thePtr->GetFileOffset() == theFileOffset) {
+                return;
+            }
+        }
+        mChunkServerInitialSeqNum += 10000;
+        ChunkWriter* const theWriterPtr = new ChunkWriter(
+            *this, mChunkServerInitialSeqNum, mLogPrefix);
+        // Keep the most recently used writer first.
+        Writers::PushBack(mWriters, *theWriterPtr);
+        theWriterPtr->AllocateAhead(theFileOffset);
     }
     int QueueWrite(
         IOBuffer& inBuffer,
@@ -2016,6 +2086,11 @@ private:
         if (0 < mReplicaCount && thePtr == &inWriter) {
             return false;
         }
+        if (inWriter.IsAllocatedAhead() && 0 <= thePtr->GetFileOffset() &&
+                thePtr->GetFileOffset() + (Offset)CHUNKSIZE ==
+                    inWriter.GetFileOffset()) {
+            return false;
+        }
         const Offset theLeftEdge = thePtr->GetOpenChunkBlockFileOffset();
         if (theLeftEdge < 0) {
             return false;
@@ -2050,7 +2125,8 @@ private:
                     }
                     delete &theWriter;
                 }
-            } else if (theWriter.IsIdle() && theWriter.IsOpen()) {
+            } else if (theWriter.IsIdle() && theWriter.IsOpen() &&
+                    ! theWriter.IsAllocatedAhead()) {
                 // Stop at the first idle that can not be closed.
                 break;
             }
@@ -2163,6 +2239,15 @@ Writer::Striper::StartQueuedWrite(
     mOuter.StartQueuedWrite(inQueuedCount);
 }
 
+void
+Writer::Striper::ParityDone(
+    int64_t inByteCount,
+    int64_t inMicroSecs)
+{
+    mOuter.mStats.mParityByteCount += inByteCount;
+    mOuter.mStats.mParityMicroSecs += inMicroSecs;
+}
+
 Writer::Writer(
     Writer::MetaServer& inMetaServer,
     Writer::Completion* inCompletionPtr               /* = 0 */,
@@ -2174,7 +2259,8 @@ Writer::Writer(
     int                 inIdleTimeoutSec              /* = 5 * 30 */,
     int                 inMaxWriteSize                /* = 1 << 20 */,
     const char*         inLogPrefixPtr                /* = 0 */,
-    int64_t             inChunkServerInitialSeqNum    /* = 1 */)
+    int64_t             inChunkServerInitialSeqNum    /* = 1 */,
+    bool                inAllocateAheadFlag           /* = false */)
     : mImpl(*new Writer::Impl(
         *this,
         inMetaServer,
@@ -2188,7 +2274,8 @@ Writer::Writer(
         inMaxWriteSize,
         (inLogPrefixPtr && inLogPrefixPtr[0]) ?
             (inLogPrefixPtr + string(" ")) : string(),
-        inChunkServerInitialSeqNum
+        inChunkServerInitialSeqNum,
+        inAllocateAheadFlag
     ))
 {
     mImpl.Ref();
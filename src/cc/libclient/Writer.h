@@ -84,7 +84,10 @@ public:
               mRetriesCount(0),
               mWriteCount(0),
               mWriteByteCount(0),
-              mBufferCompactionCount(0)
+              mBufferCompactionCount(0),
+              mChunkAllocAheadCount(0),
+              mParityByteCount(0),
+              mParityMicroSecs(0)
             {}
         void Clear()
             { *this = Stats(); }
@@ -102,6 +105,9 @@ public:
             mWriteCount            += inStats.mWriteCount;
             mWriteByteCount        += inStats.mWriteByteCount;
             mBufferCompactionCount += inStats.mBufferCompactionCount;
+            mChunkAllocAheadCount  += inStats.mChunkAllocAheadCount;
+            mParityByteCount       += inStats.mParityByteCount;
+            mParityMicroSecs       += inStats.mParityMicroSecs;
             return *this;
         }
         template<typename T>
@@ -119,6 +125,9 @@ public:
             inFunctor("Retries",          mRetriesCount);
             inFunctor("Writes" ,          mWriteCount);
             inFunctor("WriteBytes",       mWriteByteCount);
+            inFunctor("ChunkAllocAhead",  mChunkAllocAheadCount);
+            inFunctor("ParityBytes",      mParityByteCount);
+            inFunctor("ParityMicroSec",   mParityMicroSecs);
         }
         Counter mMetaOpsQueuedCount;
         Counter mMetaOpsCancelledCount;
@@ -131,6 +140,11 @@ public:
         Counter mWriteCount;
         Counter mWriteByteCount;
         Counter mBufferCompactionCount;
+        Counter mChunkAllocAheadCount;
+        // Client side parity encoding cost. Metrics only, parity is always
+        // computed and written by the client.
+        Counter mParityByteCount;
+        Counter mParityMicroSecs;
     };
     class Striper
     {
@@ -173,6 +187,10 @@ public:
             int       inWriteThreshold);
         void StartQueuedWrite(
             int inQueuedCount);
+        // Account for recovery stripes computed by the client.
+        void ParityDone(
+            int64_t inByteCount,
+            int64_t inMicroSecs);
         bool IsWriteQueued() const
             { return mWriteQueuedFlag; }
     private:
@@ -185,6 +203,9 @@ public:
             const Striper& inStipter);
     };
     typedef KfsNetClient MetaServer;
+    // With inAllocateAheadFlag set, the next chunk of a replicated file is
+    // allocated as soon as the last byte of the current chunk is queued, in
+    // order to overlap the chunk allocation with the in flight writes.
     Writer(
         MetaServer& inMetaServer,
         Completion* inCompletionPtr            = 0,
@@ -196,7 +217,8 @@ public:
         int         inIdleTimeoutSec           = 5 * 30,
         int         inMaxWriteSize             = 1 << 20,
         const char* inLogPrefixPtr             = 0,
-        int64_t     inChunkServerInitialSeqNum = 1);
+        int64_t     inChunkServerInitialSeqNum = 1,
+        bool        inAllocateAheadFlag        = false);
     virtual ~Writer();
     int Open(
         kfsFileId_t inFileId,
@@ -29,6 +29,7 @@
 
 #include "common/StdAllocator.h"
 #include "common/MsgLogger.h"
+#include "common/WeightTree.h"
 
 #include <vector>
 #include <set>
@@ -49,6 +50,7 @@ using std::make_pair;
 using std::find_if;
 using std::iter_swap;
 using std::sort;
+using std::lower_bound;
 using boost::bind;
 
 /*
@@ -71,6 +73,12 @@ using boost::bind;
  * for the initial chunk placement, unless using available space is forced by
  * the meta server configuration for initial chunk placement.
  *
+ * The per rack and storage tier server weights for the configured placement
+ * mode are maintained incrementally by the layout manager, and the servers
+ * are picked from these in O(log(n)) by rejecting the servers that are not
+ * candidates at the moment of the placement. See
+ * LayoutManager::GetPlacementWeights().
+ *
  * To minimize network transfers between the rack the re-replication and
  * re-balancing attempts to choose re-replication source and destination withing
  * the same rack. If not enough different racks available, put chunk replicas
@@ -100,7 +108,13 @@ public:
           mServerExcludes(),
           mCandidateRacks(),
           mCandidates(),
+          mCandidateWeights(),
           mLoadAvgSum(0),
+          mRackServersPtr(0),
+          mRackWeightsPtr(0),
+          mRackPtr(0),
+          mRackWeightsGeneration(0),
+          mRackPicked(),
           mRackPos(0),
           mCandidatePos(0),
           mCurRackId(-1),
@@ -114,6 +128,7 @@ public:
           mSortBySpaceUtilizationFlag(false),
           mSortCandidatesByLoadAvgFlag(false),
           mLastAttemptFlag(false),
+          mUsePlacementWeightsFlag(false),
           mMinSTier(kKfsSTierMax),
           mMaxSTier(kKfsSTierMax),
           mCurSTier(mMinSTier)
@@ -130,6 +145,8 @@ public:
         mLastAttemptFlag         = false;
         mCandidateRacks.clear();
         mCandidates.clear();
+        mCandidateWeights.Clear();
+        ClearRackCandidates();
     }
     void clear()
     {
@@ -161,6 +178,7 @@ public:
             mLayoutManager.GetMaxSpaceUtilizationThreshold();
         mMaxReplicationsPerNode       =
             mLayoutManager.GetMaxConcurrentWriteReplicationsPerNode();
+        mUsePlacementWeightsFlag      = true;
         FindCandidatesSelf(rackIdToUse);
     }
     void FindCandidatesInRack(
@@ -196,6 +214,10 @@ public:
             mLayoutManager.GetMaxSpaceUtilizationThreshold());
         mMaxReplicationsPerNode       =
             mLayoutManager.GetMaxConcurrentWriteReplicationsPerNode();
+        // The maintained placement weights can only be used if these are
+        // space utilization based.
+        mUsePlacementWeightsFlag      =
+            mLayoutManager.GetSortCandidatesBySpaceUtilizationFlag();
         FindCandidatesSelf(rackIdToUse);
     }
 
@@ -237,12 +259,20 @@ public:
             mCandidatePos = 0;
             return GetNext(canIgnoreServerExcludesFlag); // Tail recursion.
         }
+        if (mRackWeightsPtr) {
+            ChunkServer* const srv = GetNextRackCandidate();
+            if (srv) {
+                return srv->shared_from_this();
+            }
+            mCandidatePos = 0;
+        }
         if (mCandidatePos <= 0) {
             if (! canIgnoreServerExcludesFlag ||
                     ! mUsingRackExcludesFlag ||
                     mRackPos <= mRackExcludes.Size()) {
                 return ChunkServerPtr();
             }
+            ClearRackCandidates();
             mServerExcludes.SortByCount();
             mCandidatePos            = 0;
             mUsingServerExcludesFlag = true;
@@ -251,22 +281,20 @@ public:
         }
         // Random shuffle chosen servers, such that the servers with
         // smaller "load" go before the servers with larger load.
-        if (mCandidatePos == 1) {
-            return mCandidates[--mCandidatePos].second->shared_from_this();
-        }
+        // The candidate list and its weight tree are built per rack only for
+        // the last attempt, which might have all chunk servers as
+        // candidates, and if the maintained placement weights cannot be
+        // used.
         assert(mLoadAvgSum > 0);
-        int64_t rnd = Rand(mLoadAvgSum);
-        size_t  ri  = mCandidatePos--;
-        int64_t load;
-        do {
-            --ri;
-            load = mCandidates[ri].first;
-            rnd -= load;
-        } while (rnd >= 0 && ri > 0);
-        iter_swap(mCandidates.begin() + mCandidatePos,
-            mCandidates.begin() + ri);
+        const size_t ri = mCandidateWeights.Find(
+            mCandidatePos <= 1 ? int64_t(0) : Rand(mLoadAvgSum));
+        assert(ri < mCandidates.size() && 0 < mCandidates[ri].first);
+        const int64_t load = mCandidates[ri].first;
+        mCandidateWeights.SetWeight(ri, 0);
+        mCandidates[ri].first = 0;
         mLoadAvgSum -= load;
-        return mCandidates[mCandidatePos].second->shared_from_this();
+        mCandidatePos--;
+        return mCandidates[ri].second->shared_from_this();
     }
 
     bool IsUsingServerExcludes() const
@@ -575,6 +603,31 @@ public:
     RackId GetMostUsedRackId() const
         { return mRackExcludes.GetMaxId(); }
 
+    // Returns server placement weight, the reciprocal of the likelihood of
+    // the server to be chosen. For more details look at the comment at the
+    // top.
+    static int64_t GetPlacementWeight(
+        const ChunkServer& srv,
+        kfsSTier_t         tier,
+        bool               sortBySpaceUtilizationFlag,
+        bool               sortCandidatesByLoadAvgFlag,
+        int64_t            slavePlacementScale)
+    {
+        const int64_t kLoadAvgFloor = 1;
+        if (sortBySpaceUtilizationFlag) {
+            return ((int64_t)(srv.GetStorageTierSpaceUtilization(tier) *
+                (int64_t(1) << (10 + kSlaveScaleFracBits))) + kLoadAvgFloor);
+        }
+        if (sortCandidatesByLoadAvgFlag) {
+            int64_t load = srv.GetLoadAvg();
+            if (! srv.CanBeChunkMaster()) {
+                load = (load * slavePlacementScale) >> kSlaveScaleFracBits;
+            }
+            return (load + kLoadAvgFloor);
+        }
+        return kLoadAvgFloor;
+    }
+
 private:
     template <typename IdT, typename CountT, typename IdConstT = IdT>
     class IdSet
@@ -716,32 +769,40 @@ private:
             pair<int64_t, ChunkServer*>,
             StdAllocator<pair<int64_t, ChunkServer*> >
         > Candidates;
+    typedef vector<size_t, StdAllocator<size_t> > RackPicked;
     typedef Servers Sources;
     enum { kSlaveScaleFracBits = LayoutManager::kSlaveScaleFracBits };
 
-    LayoutManager&   mLayoutManager;
-    const RackInfos& mRacks;
-    RackIdSet        mRackExcludes;
-    ServerExcludes   mServerExcludes;
-    CandidateRacks   mCandidateRacks;
-    Candidates       mCandidates;
-    int64_t          mLoadAvgSum;
-    size_t           mRackPos;
-    size_t           mCandidatePos;
-    RackId           mCurRackId;
-    int64_t          mCandidatesInRacksCount;
-    int              mMaxReplicationsPerNode;
-    double           mMaxSpaceUtilizationThreshold;
-    double           mCurSTierMaxSpaceUtilizationThreshold;
-    bool             mForReplicationFlag;
-    bool             mUsingRackExcludesFlag;
-    bool             mUsingServerExcludesFlag;
-    bool             mSortBySpaceUtilizationFlag;
-    bool             mSortCandidatesByLoadAvgFlag;
-    bool             mLastAttemptFlag;
-    kfsSTier_t       mMinSTier;
-    kfsSTier_t       mMaxSTier;
-    kfsSTier_t       mCurSTier;
+    LayoutManager&    mLayoutManager;
+    const RackInfos&  mRacks;
+    RackIdSet         mRackExcludes;
+    ServerExcludes    mServerExcludes;
+    CandidateRacks    mCandidateRacks;
+    Candidates        mCandidates;
+    WeightTree        mCandidateWeights;
+    int64_t           mLoadAvgSum;
+    const Servers*    mRackServersPtr;
+    const WeightTree* mRackWeightsPtr;
+    const RackInfo*   mRackPtr;
+    uint64_t          mRackWeightsGeneration;
+    RackPicked        mRackPicked;
+    size_t            mRackPos;
+    size_t            mCandidatePos;
+    RackId            mCurRackId;
+    int64_t           mCandidatesInRacksCount;
+    int               mMaxReplicationsPerNode;
+    double            mMaxSpaceUtilizationThreshold;
+    double            mCurSTierMaxSpaceUtilizationThreshold;
+    bool              mForReplicationFlag;
+    bool              mUsingRackExcludesFlag;
+    bool              mUsingServerExcludesFlag;
+    bool              mSortBySpaceUtilizationFlag;
+    bool              mSortCandidatesByLoadAvgFlag;
+    bool              mLastAttemptFlag;
+    bool              mUsePlacementWeightsFlag;
+    kfsSTier_t        mMinSTier;
+    kfsSTier_t        mMaxSTier;
+    kfsSTier_t        mCurSTier;
 
     int64_t Rand(
         int64_t interval)
@@ -818,20 +879,13 @@ private:
     int64_t GetLoad(
         const ChunkServer& srv) const
     {
-        const int64_t kLoadAvgFloor = 1;
-        if (mSortBySpaceUtilizationFlag) {
-            return ((int64_t)(srv.GetStorageTierSpaceUtilization(mCurSTier) *
-                (int64_t(1) << (10 + kSlaveScaleFracBits))) + kLoadAvgFloor);
-        }
-        if (mSortCandidatesByLoadAvgFlag) {
-            int64_t load = srv.GetLoadAvg();
-            if (! srv.CanBeChunkMaster()) {
-                load = (load * mLayoutManager.GetSlavePlacementScale()
-                ) >> kSlaveScaleFracBits;
-            }
-            return (load + kLoadAvgFloor);
-        }
-        return kLoadAvgFloor;
+        return GetPlacementWeight(
+            srv,
+            mCurSTier,
+            mSortBySpaceUtilizationFlag,
+            mSortCandidatesByLoadAvgFlag,
+            mLayoutManager.GetSlavePlacementScale()
+        );
     }
     bool IsCandidateServer(
         const ChunkServer& srv) const
@@ -847,6 +901,10 @@ private:
     void FindCandidateServers(
         const RackInfo& rack)
     {
+        if (mUsePlacementWeightsFlag) {
+            FindRackCandidateServers(rack);
+            return;
+        }
         FindCandidateServers(
             rack.getServers(), rack.getPossibleCandidatesCount(mCurSTier));
     }
@@ -854,6 +912,7 @@ private:
         const Sources& sources,
         int            candidatesCount)
     {
+        ClearRackCandidates();
         mLoadAvgSum   = 0;
         mCandidatePos = 0;
         mCandidates.clear();
@@ -875,6 +934,77 @@ private:
             mCandidates.push_back(make_pair(load, &srv));
         }
         mCandidatePos = mCandidates.size();
+        mCandidateWeights.Build(mCandidates);
+    }
+    void ClearRackCandidates()
+    {
+        mRackServersPtr = 0;
+        mRackWeightsPtr = 0;
+        mRackPtr        = 0;
+        mRackPicked.clear();
+    }
+    void FindRackCandidateServers(
+        const RackInfo& rack)
+    {
+        ClearRackCandidates();
+        mLoadAvgSum   = 0;
+        mCandidatePos = 0;
+        mCandidates.clear();
+        mCandidateWeights.Clear();
+        if (rack.getPossibleCandidatesCount(mCurSTier) <= 0) {
+            return;
+        }
+        mRackWeightsPtr        =
+            &mLayoutManager.GetPlacementWeights(rack, mCurSTier);
+        mRackServersPtr        = &rack.getServers();
+        mRackPtr               = &rack;
+        mRackWeightsGeneration = rack.getPlacementWeightsGeneration();
+        // Pick the first server now, in order to find out if the rack has
+        // any candidates. The remaining servers are picked on demand.
+        ChunkServer* const srv = GetNextRackCandidate();
+        if (! srv) {
+            ClearRackCandidates();
+            return;
+        }
+        mCandidates.push_back(make_pair(int64_t(0), srv));
+        mCandidatePos = 1;
+    }
+    ChunkServer* GetNextRackCandidate()
+    {
+        if (! mCandidates.empty()) {
+            ChunkServer* const srv = mCandidates.back().second;
+            mCandidates.pop_back();
+            return srv;
+        }
+        if (! mRackWeightsPtr || mRackWeightsGeneration !=
+                mRackPtr->getPlacementWeightsGeneration()) {
+            // Rack servers changed, the picked indices are no longer valid.
+            return 0;
+        }
+        // The weights are shared, exclude picked and rejected servers by
+        // maintaining the ordered list of their indices.
+        const WeightTree& weights = *mRackWeightsPtr;
+        for (; ;) {
+            int64_t sum = weights.GetSum();
+            for (RackPicked::const_iterator it = mRackPicked.begin();
+                    it != mRackPicked.end();
+                    ++it) {
+                sum -= weights.GetWeight(*it);
+            }
+            if (sum <= 0) {
+                return 0;
+            }
+            const size_t ri = weights.Find(
+                Rand(sum), mRackPicked.begin(), mRackPicked.end());
+            assert(ri < mRackServersPtr->size() &&
+                0 < weights.GetWeight(ri));
+            mRackPicked.insert(lower_bound(
+                mRackPicked.begin(), mRackPicked.end(), ri), ri);
+            ChunkServer& srv = *((*mRackServersPtr)[ri]);
+            if (IsCandidateServer(srv) && ! mServerExcludes.Find(&srv)) {
+                return &srv;
+            }
+        }
     }
     void NextTier()
     {
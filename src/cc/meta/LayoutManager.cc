@@ -1904,6 +1904,8 @@ LayoutManager::SetParameters(const Properties& props, int clientPort)
     mSortCandidatesByLoadAvgFlag = props.getValue(
         "metaServer.sortCandidatesByLoadAvg",
         mSortCandidatesByLoadAvgFlag ? 1 : 0) != 0;
+    // The placement weights depend on the above.
+    ClearPlacementWeights();
 
     mMaxFsckFiles = props.getValue(
         "metaServer.maxFsckChunks",
@@ -4591,6 +4593,91 @@ LayoutManager::UpdateGoodCandidateLoadAvg()
         max(mCSSlavePossibleCandidateCount, 1));
 }
 
+int64_t
+LayoutManager::GetPlacementWeight(const ChunkServer& srv, kfsSTier_t tier,
+    int64_t slaveScale) const
+{
+    if (! srv.GetCanBeCandidateServerFlag(tier)) {
+        return 0;
+    }
+    return KFS::ChunkPlacement<LayoutManager>::GetPlacementWeight(
+        srv,
+        tier,
+        mSortCandidatesBySpaceUtilizationFlag,
+        mSortCandidatesByLoadAvgFlag,
+        slaveScale
+    );
+}
+
+const WeightTree&
+LayoutManager::GetPlacementWeights(const RackInfo& rack, kfsSTier_t tier)
+{
+    // The weights are kept up to date by UpdatePlacementWeights() on every
+    // server load and storage tier change. The weights of the servers that
+    // cannot be chunk masters depend on the slave placement scale, update
+    // these when the scale changes.
+    const Servers&              servers = rack.getServers();
+    RackInfo::PlacementWeights& pw      = rack.getPlacementWeights(tier);
+    const int64_t               scale   = GetSlavePlacementScale();
+    if (pw.weights.GetSize() != servers.size()) {
+        pw.slaveScale = scale;
+        pw.weights.Resize(servers.size());
+        for (size_t i = 0; i < servers.size(); i++) {
+            pw.weights.SetWeight(i,
+                GetPlacementWeight(*servers[i], tier, pw.slaveScale));
+        }
+    } else if (pw.slaveScale != scale) {
+        pw.slaveScale = scale;
+        if (mSortCandidatesByLoadAvgFlag &&
+                ! mSortCandidatesBySpaceUtilizationFlag) {
+            for (size_t i = 0; i < servers.size(); i++) {
+                if (! servers[i]->CanBeChunkMaster()) {
+                    pw.weights.SetWeight(i,
+                        GetPlacementWeight(*servers[i], tier, pw.slaveScale));
+                }
+            }
+        }
+    }
+    return pw.weights;
+}
+
+void
+LayoutManager::UpdatePlacementWeights(const ChunkServer& srv)
+{
+    RackInfos::iterator const rackIter = FindRack(srv.GetRack());
+    if (rackIter == mRacks.end()) {
+        return;
+    }
+    const Servers& servers = rackIter->getServers();
+    size_t         idx     = servers.size();
+    for (size_t i = 0; i < kKfsSTierCount; i++) {
+        RackInfo::PlacementWeights& pw = rackIter->getPlacementWeights(i);
+        if (pw.weights.GetSize() != servers.size()) {
+            continue; // Not built yet, or invalidated.
+        }
+        if (servers.size() <= idx) {
+            for (idx = 0;
+                    idx < servers.size() && servers[idx].get() != &srv;
+                    idx++)
+                {}
+            if (servers.size() <= idx) {
+                return;
+            }
+        }
+        pw.weights.SetWeight(idx, GetPlacementWeight(srv, i, pw.slaveScale));
+    }
+}
+
+void
+LayoutManager::ClearPlacementWeights()
+{
+    for (RackInfos::const_iterator it = mRacks.begin();
+            it != mRacks.end();
+            ++it) {
+        it->clearPlacementWeights();
+    }
+}
+
 bool
 LayoutManager::IsCandidateServer(
     const ChunkServer& c,
@@ -4684,6 +4771,7 @@ LayoutManager::UpdateSrvLoadAvg(ChunkServer& srv, int64_t delta,
         }
         racksCandidatesDelta[i] = flag ? 1 : -1;
     }
+    UpdatePlacementWeights(srv);
     if (isPossibleCandidate && candidateTiersCount <= 0) {
         isPossibleCandidate = false;
     }
@@ -6979,6 +7067,9 @@ LayoutManager::Ping(IOBuffer& buf, bool wormModeFlag)
         "Build-version: "       << KFS_BUILD_VERSION_STRING << "\r\n"
         "Source-version: "      << KFS_SOURCE_REVISION_STRING << "\r\n"
         "WORM: "                << (wormModeFlag ? "1" : "0") << "\r\n"
+        "Total-space: "         << pinger.totalSpace << "\r\n"
+        "Used-space: "          << pinger.usedSpace << "\r\n"
+        "Free-space: "          << pinger.freeFsSpace << "\r\n"
         "System Info: "
         "Up since= "            << DisplayDateTime(kSecs2MicroSecs * mStartTime) << "\t"
         "Total space= "         << pinger.totalSpace << "\t"
@@ -47,6 +47,7 @@
 #include "common/LinearHash.h"
 #include "common/StBuffer.h"
 #include "common/TimerWheel.h"
+#include "common/WeightTree.h"
 #include "common/PoolAllocator.h"
 #include "qcdio/QCDLList.h"
 #include "kfsio/KfsCallbackObj.h"
@@ -632,11 +633,26 @@ public:
     typedef double                       RackWeight;
     typedef CSMap::Servers               Servers;
 
+    // Chunk placement candidate server weights for a storage tier, in the
+    // same order as the servers. Built on the first use, and then updated
+    // incrementally on the server load and space changes, see
+    // LayoutManager::GetPlacementWeights().
+    struct PlacementWeights
+    {
+        PlacementWeights()
+            : weights(),
+              slaveScale(-1)
+            {}
+        WeightTree weights;
+        int64_t    slaveScale;
+    };
+
     RackInfo()
         : mRackId(-1),
           mPossibleCandidatesCount(0),
           mRackWeight(1.0),
-          mServers()
+          mServers(),
+          mPlacementWeightsGeneration(0)
     {
         for (size_t i = 0; i < kKfsSTierCount; i++) {
             mTierCandidateCount[i] = 0;
@@ -649,7 +665,8 @@ public:
         : mRackId(id),
           mPossibleCandidatesCount(0),
           mRackWeight(1.0),
-          mServers()
+          mServers(),
+          mPlacementWeightsGeneration(0)
     {
         RackInfo::addServer(server);
         for (size_t i = 0; i < kKfsSTierCount; i++) {
@@ -661,12 +678,14 @@ public:
     }
     void addServer(const ChunkServerPtr& server) {
         mServers.push_back(server);
+        clearPlacementWeights();
     }
     void removeServer(const ChunkServerPtr& server) {
         Servers::iterator const iter = find(
             mServers.begin(), mServers.end(), server);
         if (iter != mServers.end()) {
             mServers.erase(iter);
+            clearPlacementWeights();
         }
     }
     const Servers& getServers() const {
@@ -709,13 +728,29 @@ public:
     const StorageTierInfo* getStorageTiersInfo() const {
         return mStorageTierInfo;
     }
+    PlacementWeights& getPlacementWeights(kfsSTier_t tier) const {
+        return mPlacementWeights[tier];
+    }
+    // Changes when the placement weights are invalidated, and the server
+    // indices might change.
+    uint64_t getPlacementWeightsGeneration() const {
+        return mPlacementWeightsGeneration;
+    }
+    void clearPlacementWeights() const {
+        for (size_t i = 0; i < kKfsSTierCount; i++) {
+            mPlacementWeights[i].weights.Clear();
+        }
+        mPlacementWeightsGeneration++;
+    }
 private:
-    RackId          mRackId;
-    int             mPossibleCandidatesCount;
-    RackWeight      mRackWeight;
-    Servers         mServers;
-    int             mTierCandidateCount[kKfsSTierCount];
-    StorageTierInfo mStorageTierInfo[kKfsSTierCount];
+    RackId                   mRackId;
+    int                      mPossibleCandidatesCount;
+    RackWeight               mRackWeight;
+    Servers                  mServers;
+    int                      mTierCandidateCount[kKfsSTierCount];
+    StorageTierInfo          mStorageTierInfo[kKfsSTierCount];
+    mutable PlacementWeights mPlacementWeights[kKfsSTierCount];
+    mutable uint64_t         mPlacementWeightsGeneration;
 };
 
 typedef map<
@@ -1338,6 +1373,8 @@ public:
     bool GetUseFsTotalSpaceFlag() const
         { return mUseFsTotalSpaceFlag; }
     int64_t GetSlavePlacementScale();
+    const WeightTree& GetPlacementWeights(
+        const RackInfo& rack, kfsSTier_t tier);
     int GetMaxConcurrentWriteReplicationsPerNode() const
         { return mMaxConcurrentWriteReplicationsPerNode; }
     const Servers& GetChunkServers() const
@@ -2388,6 +2425,10 @@ protected:
         bool deleteRetiringFlag = false);
     void DeleteChunk(fid_t fid, chunkId_t chunkId, const Servers& servers);
     void UpdateGoodCandidateLoadAvg();
+    int64_t GetPlacementWeight(const ChunkServer& srv, kfsSTier_t tier,
+        int64_t slaveScale) const;
+    void UpdatePlacementWeights(const ChunkServer& srv);
+    void ClearPlacementWeights();
     inline static CSMap::Entry& GetCsEntry(MetaChunkInfo& chunkInfo);
     inline static CSMap::Entry* GetCsEntry(MetaChunkInfo* chunkInfo);
     bool CanBeRecovered(
@@ -135,6 +135,89 @@ setChunkmapDumpDir(string d)
     gChunkmapDumpDir = d;
 }
 
+/*!
+ * Recently modified directories ring. The clients that cache directory
+ * entries attributes pass the last seen sequence number with each request,
+ * and the directories modified since then are piggybacked to the response.
+ * Directory rename, mode and ownership change invalidate all client side
+ * cached entries, as these might affect the entire sub tree.
+ */
+class DirChangeLog
+{
+public:
+    DirChangeLog()
+        : mFids(),
+          mSeq(microseconds()),
+          mStartSeq(mSeq),
+          mMaxReportCount(256)
+        {}
+    void SetParameters(const Properties& props)
+    {
+        const size_t size = (size_t)max(0, props.getValue(
+            "metaServer.dirChangeLogSize", (int)(4 << 10)));
+        mMaxReportCount = max(0, props.getValue(
+            "metaServer.dirChangeMaxReportCount", mMaxReportCount));
+        if (size != mFids.size()) {
+            mFids.assign(size, fid_t(kAll));
+            mStartSeq = mSeq;
+        }
+    }
+    void Changed(fid_t dir)
+    {
+        if (! mFids.empty()) {
+            mFids[(size_t)(mSeq++ % (seq_t)mFids.size())] = dir;
+        }
+    }
+    void Changed(const MetaFattr* fa)
+    {
+        if (fa) {
+            Changed(fa->parent ? fa->parent->id() : fid_t(kAll));
+        }
+    }
+    void ChangedAll()
+        { Changed(fid_t(kAll)); }
+    void Get(seq_t seq, string& changes) const
+    {
+        changes.clear();
+        if (mFids.empty() || seq < 0) {
+            return;
+        }
+        ostringstream& os = GetTmpOStringStream();
+        os << "Dir-change-seq: " << mSeq;
+        if (seq != mSeq) {
+            os << "\r\nDir-changes: ";
+            if (seq < mStartSeq || mSeq < seq ||
+                    (seq_t)min(mFids.size(), (size_t)mMaxReportCount) <
+                        mSeq - seq) {
+                os << "*";
+            } else {
+                const char* sep = "";
+                for (seq_t i = seq; i < mSeq; i++) {
+                    const fid_t fid = mFids[(size_t)(i % (seq_t)mFids.size())];
+                    if (fid == kAll) {
+                        os.str(string());
+                        os << "Dir-change-seq: " << mSeq <<
+                            "\r\nDir-changes: *";
+                        break;
+                    }
+                    os << sep << fid;
+                    sep = ",";
+                }
+            }
+        }
+        changes = os.str();
+    }
+private:
+    enum { kAll = -1 };
+    typedef vector<fid_t> Fids;
+
+    Fids  mFids;
+    seq_t mSeq;
+    seq_t mStartSeq;
+    int   mMaxReportCount;
+};
+static DirChangeLog sDirChangeLog;
+
 inline static bool
 OkHeader(const MetaRequest* op, ostream &os, bool checkStatus = true)
 {
@@ -142,6 +225,9 @@ OkHeader(const MetaRequest* op, ostream &os, bool checkStatus = true)
         "OK\r\n"
         "Cseq: " << op->opSeqno
     ;
+    if (! op->dirChanges.empty()) {
+        os << "\r\n" << op->dirChanges;
+    }
     if (op->status == 0 && op->statusMsg.empty()) {
         os <<
             "\r\n"
@@ -172,6 +258,50 @@ OkHeader(const MetaRequest* op, ostream &os, bool checkStatus = true)
     return (op->status >= 0);
 }
 
+inline static bool
+OkHeader(const MetaRequest* op, IntIOBufferWriter& writer,
+    bool checkStatus = true)
+{
+    writer.WriteLiteral(
+        "OK\r\n"
+        "Cseq: "
+    );
+    writer.WriteInt(op->opSeqno);
+    if (! op->dirChanges.empty()) {
+        writer.WriteLiteral("\r\n");
+        writer.Write(op->dirChanges.data(), op->dirChanges.size());
+    }
+    if (op->status == 0 && op->statusMsg.empty()) {
+        writer.WriteLiteral(
+            "\r\n"
+            "Status: 0\r\n"
+        );
+        return true;
+    }
+    writer.WriteLiteral(
+        "\r\n"
+        "Status: "
+    );
+    writer.WriteInt(op->status >= 0 ? op->status :
+        -SysToKfsErrno(-op->status));
+    writer.WriteLiteral("\r\n");
+    if (! op->statusMsg.empty()) {
+        const size_t p = op->statusMsg.find('\r');
+        assert(
+            string::npos == p &&
+            op->statusMsg.find('\n') == string::npos
+        );
+        writer.WriteLiteral("Status-message: ");
+        writer.Write(op->statusMsg.data(),
+            p == string::npos ? op->statusMsg.size() : p);
+        writer.WriteLiteral("\r\n");
+    }
+    if (checkStatus && op->status < 0) {
+        writer.WriteLiteral("\r\n");
+    }
+    return (op->status >= 0);
+}
+
 inline static ostream&
 PutHeader(const MetaRequest* op, ostream &os)
 {
@@ -839,6 +969,7 @@ MetaCreate::handle()
             minSTier = fa->minSTier;
             maxSTier = fa->maxSTier;
         }
+        sDirChangeLog.Changed(dir);
     }
 }
 
@@ -860,6 +991,7 @@ MetaMkdir::handle()
     if (status == 0 && fa) {
         minSTier = fa->minSTier;
         maxSTier = fa->maxSTier;
+        sDirChangeLog.Changed(dir);
     }
 }
 
@@ -917,6 +1049,9 @@ MetaRemove::handle()
     mtime = microseconds();
     status = metatree.remove(dir, name, pathname, todumpster,
         euser, egroup, mtime);
+    if (status == 0) {
+        sDirChangeLog.Changed(dir);
+    }
 }
 
 /* virtual */ void
@@ -934,6 +1069,9 @@ MetaRmdir::handle()
     }
     mtime = microseconds();
     status = metatree.rmdir(dir, name, pathname, euser, egroup, mtime);
+    if (status == 0) {
+        sDirChangeLog.Changed(dir);
+    }
 }
 
 static vector<MetaDentry*>&
@@ -1048,19 +1186,6 @@ public:
     }
 };
 
-class ListServerLocations
-{
-    ostream& os;
-public:
-    ListServerLocations(ostream &out)
-        : os(out)
-        {}
-    void operator()(const ServerLocation& s) const
-    {
-        os << " " << s;
-    }
-};
-
 template<bool ShortFormatFlag>
 class ReaddirPlusWriter
 {
@@ -1755,10 +1880,10 @@ MetaGetlayout::handle()
     if ((hasMoreChunksFlag = maxResCnt > 0 && maxResCnt < numChunks)) {
         numChunks = maxResCnt;
     }
-    ostream&        os     = sWOStream.Set(resp);
-    const char*     prefix = "";
-    Servers         c;
-    ChunkLayoutInfo l;
+    const int         maxSize = gLayoutManager.GetMaxResponseSize();
+    IntIOBufferWriter writer(resp);
+    Servers           c;
+    ChunkLayoutInfo   l;
     for (int i = 0; i < numChunks; i++) {
         l.locations.clear();
         l.offset       = chunkInfo[i]->offset;
@@ -1779,18 +1904,34 @@ MetaGetlayout::handle()
             for_each(c.begin(), c.end(),
                 EnumerateLocations(l.locations));
         }
-        if (! (os << prefix << l)) {
+        if (0 < i) {
+            writer.Write(" ", 1);
+        }
+        writer.WriteInt(l.offset);
+        writer.Write(" ", 1);
+        writer.WriteInt(l.chunkId);
+        writer.Write(" ", 1);
+        writer.WriteInt(l.chunkVersion);
+        writer.Write(" ", 1);
+        writer.WriteInt(l.locations.size());
+        for (ServerLocations::const_iterator it = l.locations.begin();
+                it != l.locations.end();
+                ++it) {
+            writer.Write(" ", 1);
+            writer.Write(it->hostname);
+            writer.Write(" ", 1);
+            writer.WriteInt(it->port);
+        }
+        if (maxSize < writer.GetTotalSize()) {
+            resp.Clear();
+            status    = -ENOMEM;
+            statusMsg = "response exceeds max. size";
             break;
         }
-        prefix = " ";
     }
-    os.flush();
-    if (status == 0 && ! os) {
-        resp.Clear();
-        status    = -ENOMEM;
-        statusMsg = "response exceeds max. size";
+    if (status == 0) {
+        writer.Close();
     }
-    sWOStream.Reset();
 }
 
 /* virtual */ bool
@@ -2369,6 +2510,9 @@ MetaTruncate::handle()
     }
     status = metatree.truncate(fid, offset, &mtime, eu, egroup,
         endOffset, setEofHintFlag);
+    if (status == 0) {
+        sDirChangeLog.Changed(metatree.getFattr(fid));
+    }
 }
 
 /* virtual */ void
@@ -2393,6 +2537,18 @@ MetaRename::handle()
     mtime = microseconds();
     status = metatree.rename(dir, oldname, newname,
         oldpath, overwrite, todumpster, euser, egroup, mtime);
+    if (status != 0) {
+        return;
+    }
+    if (metatree.lookupPath(
+            dir, newname, kKfsUserRoot, kKfsGroupRoot, fa) != 0 ||
+            ! fa || fa->type == KFS_DIR) {
+        // Cached paths of the directory sub tree are no longer valid.
+        sDirChangeLog.ChangedAll();
+    } else {
+        sDirChangeLog.Changed(dir);
+        sDirChangeLog.Changed(fa);
+    }
 }
 
 /* virtual */ void
@@ -2415,6 +2571,7 @@ MetaSetMtime::handle()
     }
     fa->mtime = mtime;
     fid       = fa->id();
+    sDirChangeLog.Changed(fa);
 }
 
 /* virtual */ void
@@ -2473,6 +2630,7 @@ MetaChangeFileReplication::handle()
             minSTier = kKfsSTierUndef;
             maxSTier = kKfsSTierUndef;
         }
+        sDirChangeLog.Changed(fa);
     } else {
         logFlag = false;
     }
@@ -2491,6 +2649,10 @@ MetaCoalesceBlocks::handle()
         srcPath, dstPath, srcFid, dstFid,
         dstStartOffset, &mtime, numChunksMoved,
         euser, egroup);
+    if (status == 0) {
+        sDirChangeLog.Changed(metatree.getFattr(srcFid));
+        sDirChangeLog.Changed(metatree.getFattr(dstFid));
+    }
     KFS_LOG_STREAM(status == 0 ?
             MsgLogger::kLogLevelINFO : MsgLogger::kLogLevelERROR) <<
         "coalesce blocks " << srcPath << "->" << dstPath <<
@@ -2692,6 +2854,11 @@ MetaChmod::handle()
     }
     status = 0;
     fa->mode = mode;
+    if (fa->type == KFS_DIR) {
+        sDirChangeLog.ChangedAll();
+    } else {
+        sDirChangeLog.Changed(fa);
+    }
 }
 
 /* virtual */ void
@@ -2730,6 +2897,11 @@ MetaChown::handle()
     if (group != kKfsGroupNone) {
         fa->group = group;
     }
+    if (fa->type == KFS_DIR) {
+        sDirChangeLog.ChangedAll();
+    } else {
+        sDirChangeLog.Changed(fa);
+    }
 }
 
 /* virtual */ void
@@ -3503,6 +3675,9 @@ submit_request(MetaRequest *r)
     if (r->suspended) {
         r->processTime = microseconds() - r->processTime;
     } else {
+        if (0 <= r->dirChangeSeq) {
+            sDirChangeLog.Get(r->dirChangeSeq, r->dirChanges);
+        }
         oplog.dispatch(r);
     }
 }
@@ -4042,6 +4217,7 @@ MetaRequest::SetParameters(const Properties& props)
         "metaServer.request.requireHeaderChecksum", 0) != 0;
     sVerifyHeaderChecksumFlag = props.getValue(
         "metaServer.request.verifyHeaderChecksum", 1) != 0;
+    sDirChangeLog.SetParameters(props);
 }
 
 /* static */ uint32_t
@@ -4170,46 +4346,57 @@ MetaRmdir::response(ostream &os)
     PutHeader(this, os) << "\r\n";
 }
 
+// The following replies can be large and / or frequent. Their headers are
+// written directly into the connection output buffer with IntIOBufferWriter,
+// bypassing ostream formatting. The ostream is not used, therefore has no
+// pending data to flush.
+
 void
-MetaReaddir::response(ostream& os, IOBuffer& buf)
-{
-    if (! OkHeader(this, os)) {
-        return;
+MetaReaddir::response(ostream& /* os */, IOBuffer& buf)
+{
+    IntIOBufferWriter writer(buf);
+    if (OkHeader(this, writer)) {
+        writer.WriteLiteral("Num-Entries: ");
+        writer.WriteInt(numEntries);
+        writer.WriteLiteral("\r\nHas-more-entries: ");
+        writer.WriteInt(hasMoreEntriesFlag ? 1 : 0);
+        writer.WriteLiteral("\r\nContent-length: ");
+        writer.WriteInt(resp.BytesConsumable());
+        writer.WriteLiteral("\r\n\r\n");
+    }
+    writer.Close();
+    if (status >= 0) {
+        buf.Move(&resp);
     }
-    os <<
-        "Num-Entries: "      << numEntries << "\r\n"
-        "Has-more-entries: " << (hasMoreEntriesFlag ? 1 : 0) << "\r\n"
-        "Content-length: "   << resp.BytesConsumable() << "\r\n"
-    "\r\n";
-    os.flush();
-    buf.Move(&resp);
 }
 
 void
-MetaReaddirPlus::response(ostream& os, IOBuffer& buf)
+MetaReaddirPlus::response(ostream& /* os */, IOBuffer& buf)
 {
-    if (! OkHeader(this, os)) {
+    IntIOBufferWriter writer(buf);
+    if (! OkHeader(this, writer)) {
+        writer.Close();
         return;
     }
     size_t   entryCount;
     IOBuffer resp;
     if (numEntries >= 0) {
-        ReaddirPlusWriter<true> writer(
+        ReaddirPlusWriter<true> entryWriter(
             resp,
             maxRespSize,
             getLastChunkInfoOnlyIfSizeUnknown,
             omitLastChunkInfoFlag,
             fileIdAndTypeOnlyFlag);
-        entryCount = writer.Write(dentries, lastChunkInfos,
+        entryCount = entryWriter.Write(dentries, lastChunkInfos,
             noAttrsFlag, GetUserAndGroupNames(*this));
     } else {
-        ReaddirPlusWriter<false> writer(
+        ReaddirPlusWriter<false> entryWriter(
             resp,
             maxRespSize,
             getLastChunkInfoOnlyIfSizeUnknown,
             omitLastChunkInfoFlag,
             fileIdAndTypeOnlyFlag);
-        entryCount = writer.Write(dentries, lastChunkInfos,
+        entryCount = entryWriter.Write(dentries, lastChunkInfos,
             noAttrsFlag, GetUserAndGroupNames(*this));
     }
     hasMoreEntriesFlag = hasMoreEntriesFlag || entryCount < dentries.size();
@@ -4223,15 +4410,18 @@ MetaReaddirPlus::response(ostream& os, IOBuffer& buf)
         resp.Clear();
         status    = -ENOMEM;
         statusMsg = "response exceeds max. size";
-        OkHeader(this, os);
+        OkHeader(this, writer);
+        writer.Close();
         return;
     }
-    os <<
-        "Num-Entries: "      << entryCount << "\r\n"
-        "Has-more-entries: " << (hasMoreEntriesFlag ? 1 : 0) << "\r\n"
-        "Content-length: "   << resp.BytesConsumable() << "\r\n"
-    "\r\n";
-    os.flush();
+    writer.WriteLiteral("Num-Entries: ");
+    writer.WriteInt(entryCount);
+    writer.WriteLiteral("\r\nHas-more-entries: ");
+    writer.WriteInt(hasMoreEntriesFlag ? 1 : 0);
+    writer.WriteLiteral("\r\nContent-length: ");
+    writer.WriteInt(resp.BytesConsumable());
+    writer.WriteLiteral("\r\n\r\n");
+    writer.Close();
     buf.Move(&resp);
 }
 
@@ -4248,43 +4438,62 @@ MetaSetMtime::response(ostream &os)
 }
 
 void
-MetaGetalloc::response(ostream& os)
+MetaGetalloc::response(ostream& /* os */, IOBuffer& buf)
 {
-    if (! OkHeader(this, os)) {
+    IntIOBufferWriter writer(buf);
+    if (! OkHeader(this, writer)) {
+        writer.Close();
         return;
     }
-    os <<
-        "Chunk-handle: "  << chunkId << "\r\n"
-        "Chunk-version: " << chunkVersion << "\r\n";
+    writer.WriteLiteral("Chunk-handle: ");
+    writer.WriteInt(chunkId);
+    writer.WriteLiteral("\r\nChunk-version: ");
+    writer.WriteInt(chunkVersion);
+    writer.WriteLiteral("\r\n");
     if (replicasOrderedFlag) {
-        os << "Replicas-ordered: 1\r\n";
+        writer.WriteLiteral("Replicas-ordered: 1\r\n");
     }
-    os << "Num-replicas: " << locations.size() << "\r\n";
+    writer.WriteLiteral("Num-replicas: ");
+    writer.WriteInt(locations.size());
+    writer.WriteLiteral("\r\n");
 
     assert(locations.size() > 0);
 
-    os << "Replicas:";
-    for_each(locations.begin(), locations.end(), ListServerLocations(os));
-    os << "\r\n\r\n";
+    writer.WriteLiteral("Replicas:");
+    for (ServerLocations::const_iterator it = locations.begin();
+            it != locations.end();
+            ++it) {
+        writer.Write(" ", 1);
+        writer.Write(it->hostname);
+        writer.Write(" ", 1);
+        writer.WriteInt(it->port);
+    }
+    writer.WriteLiteral("\r\n\r\n");
+    writer.Close();
 }
 
 void
-MetaGetlayout::response(ostream& os, IOBuffer& buf)
+MetaGetlayout::response(ostream& /* os */, IOBuffer& buf)
 {
-    if (! OkHeader(this, os)) {
+    IntIOBufferWriter writer(buf);
+    if (! OkHeader(this, writer)) {
+        writer.Close();
         return;
     }
     if (hasMoreChunksFlag) {
-        os << "Has-more-chunks:  1\r\n";
+        writer.WriteLiteral("Has-more-chunks:  1\r\n");
     }
     if (0 <= fileSize) {
-        os << "File-size: " << fileSize << "\r\n";
-    }
-    os <<
-        "Num-chunks: "     << numChunks << "\r\n"
-        "Content-length: " << resp.BytesConsumable() << "\r\n"
-    "\r\n";
-    os.flush();
+        writer.WriteLiteral("File-size: ");
+        writer.WriteInt(fileSize);
+        writer.WriteLiteral("\r\n");
+    }
+    writer.WriteLiteral("Num-chunks: ");
+    writer.WriteInt(numChunks);
+    writer.WriteLiteral("\r\nContent-length: ");
+    writer.WriteInt(resp.BytesConsumable());
+    writer.WriteLiteral("\r\n\r\n");
+    writer.Close();
     buf.Move(&resp);
 }
 
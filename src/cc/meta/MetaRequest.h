@@ -207,6 +207,8 @@ struct MetaRequest {
     kfsGid_t        egroup;
     int64_t         maxWaitMillisec;
     int64_t         sessionEndTime;
+    seq_t           dirChangeSeq;    //!< client's last seen dir change seq.
+    string          dirChanges;      //!< dir changes response header.
     MetaRequest*    next;
     KfsCallbackObj* clnt;            //!< a handle to the client that generated this request.
     MetaRequest(MetaOp o, bool mu, seq_t opSeq = -1)
@@ -232,6 +234,8 @@ struct MetaRequest {
           egroup(kKfsGroupNone),
           maxWaitMillisec(-1),
           sessionEndTime(),
+          dirChangeSeq(-1),
+          dirChanges(),
           next(0),
           clnt(0)
         { MetaRequest::Init(); }
@@ -272,6 +276,7 @@ struct MetaRequest {
         .Def("UserId",                  &MetaRequest::euser,  kKfsUserNone)
         .Def("GroupId",                 &MetaRequest::egroup, kKfsGroupNone)
         .Def("Max-wait-ms",             &MetaRequest::maxWaitMillisec, int64_t(-1))
+        .Def("Dir-change-seq",          &MetaRequest::dirChangeSeq,    seq_t(-1))
         ;
     }
     virtual ostream& ShowSelf(ostream& os) const = 0;
@@ -808,7 +813,7 @@ struct MetaGetalloc: public MetaRequest {
         {}
     virtual void handle();
     virtual int log(ostream &file) const;
-    virtual void response(ostream &os);
+    virtual void response(ostream &os, IOBuffer& buf);
     virtual ostream& ShowSelf(ostream& os) const
     {
         return os <<
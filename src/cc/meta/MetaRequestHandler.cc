@@ -66,6 +66,7 @@ static const MetaRequestHandler& MakeMetaRequestHandler()
     .MakeParser<MetaDelegate             >("DELEGATE")
     .MakeParser<MetaDelegateCancel       >("DELEGATE_CANCEL")
     .MakeParser<MetaForceChunkReplication>("FORCE_REPLICATION")
+    .DefDone()
     ;
 }
 static const MetaRequestHandler& sMetaRequestHandler = MakeMetaRequestHandler();
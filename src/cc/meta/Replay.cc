@@ -37,14 +37,20 @@
 #include "common/RequestParser.h"
 #include "common/juliantime.h"
 #include "qcdio/QCUtils.h"
+#include "qcdio/QCThread.h"
+#include "qcdio/QCMutex.h"
+#include "qcdio/qcstutils.h"
 
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <fcntl.h>
 
 #include <cassert>
 #include <cstdlib>
+#include <cerrno>
 #include <iostream>
+#include <streambuf>
 #include <sstream>
 
 namespace KFS
@@ -58,6 +64,243 @@ Replay::setRollSeeds(int64_t roll)
     rollSeeds = roll;
 }
 
+/*!
+ * \brief log file read ahead.
+ *
+ * Reads the log file being replayed in a separate thread into the fixed number
+ * of buffers, in order to overlap the log file I/O with the log entries
+ * parsing and the meta tree updates in the replay thread. The log file read
+ * starts when the log is opened, i.e. for the first log segment while the
+ * checkpoint load is still in progress.
+ */
+class Replay::ReadAhead : public std::streambuf, public QCRunnable
+{
+public:
+    ReadAhead()
+        : std::streambuf(),
+          QCRunnable(),
+          mMutex(),
+          mCond(),
+          mThread(),
+          mFd(-1),
+          mError(0),
+          mBytesRead(0),
+          mReadPos(0),
+          mWritePos(0),
+          mFullCount(0),
+          mConsumingFlag(false),
+          mConsumedFlag(false),
+          mEofFlag(false),
+          mStopFlag(false)
+    {
+        for (int i = 0; i < kBufferCount; i++) {
+            mBuffers[i] = 0;
+            mLengths[i] = 0;
+        }
+    }
+    virtual ~ReadAhead()
+    {
+        ReadAhead::Close();
+        for (int i = 0; i < kBufferCount; i++) {
+            delete [] mBuffers[i];
+        }
+    }
+    int Open(
+        const char* fileName)
+    {
+        Close();
+        mFd = open(fileName, O_RDONLY);
+        if (mFd < 0) {
+            const int err = errno;
+            return (err > 0 ? -err : -EIO);
+        }
+        posix_fadvise(mFd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        for (int i = 0; i < kBufferCount; i++) {
+            if (! mBuffers[i]) {
+                mBuffers[i] = new char[kBufferSize];
+            }
+            mLengths[i] = 0;
+        }
+        mError         = 0;
+        mBytesRead     = 0;
+        mReadPos       = 0;
+        mWritePos      = 0;
+        mFullCount     = 0;
+        mConsumingFlag = false;
+        mConsumedFlag  = false;
+        mEofFlag       = false;
+        mStopFlag      = false;
+        setg(0, 0, 0);
+        const int kStackSize = 64 << 10;
+        const int err = mThread.TryToStart(this, kStackSize, "ReplayReadAhead");
+        if (err) {
+            close(mFd);
+            mFd = -1;
+            return (err > 0 ? -err : -EIO);
+        }
+        return 0;
+    }
+    void Close()
+    {
+        if (mFd < 0) {
+            return;
+        }
+        if (mThread.IsStarted()) {
+            QCStMutexLocker locker(mMutex);
+            mStopFlag = true;
+            mCond.Notify();
+        }
+        mThread.Join();
+        close(mFd);
+        mFd = -1;
+        setg(0, 0, 0);
+    }
+    bool IsOpen() const
+        { return (0 <= mFd); }
+    // Returns true if the file is open, nothing was consumed yet, and the
+    // file is the same as the one with the specified name.
+    bool IsOpenAtStart(
+        const char* fileName) const
+    {
+        if (mFd < 0 || mConsumedFlag) {
+            return false;
+        }
+        struct stat theOpenStat;
+        struct stat theStat;
+        return (fstat(mFd, &theOpenStat) == 0 &&
+            stat(fileName, &theStat) == 0 &&
+            theOpenStat.st_dev == theStat.st_dev &&
+            theOpenStat.st_ino == theStat.st_ino);
+    }
+    int GetError() const
+    {
+        QCStMutexLocker locker(mMutex);
+        return mError;
+    }
+    int64_t GetBytesRead() const
+    {
+        QCStMutexLocker locker(mMutex);
+        return mBytesRead;
+    }
+    virtual void Run()
+    {
+        QCStMutexLocker locker(mMutex);
+        for (; ;) {
+            while (kBufferCount <= mFullCount && ! mStopFlag) {
+                mCond.Wait(mMutex);
+            }
+            if (mStopFlag) {
+                break;
+            }
+            const int idx = mWritePos;
+            char*     buf = mBuffers[idx];
+            ssize_t   len = 0;
+            int       err = 0;
+            {
+                QCStMutexUnlocker unlocker(mMutex);
+                while (len < kBufferSize) {
+                    const ssize_t nrd = read(mFd, buf + len, kBufferSize - len);
+                    if (nrd < 0) {
+                        err = errno;
+                        if (err == EINTR) {
+                            err = 0;
+                            continue;
+                        }
+                        break;
+                    }
+                    if (nrd == 0) {
+                        break;
+                    }
+                    len += nrd;
+                }
+            }
+            if (0 < len) {
+                mLengths[idx] = (int)len;
+                mWritePos     = (idx + 1) % kBufferCount;
+                mFullCount++;
+                mBytesRead += len;
+            }
+            if (err != 0 || len < kBufferSize) {
+                mError   = err;
+                mEofFlag = true;
+            }
+            mCond.Notify();
+            if (mEofFlag) {
+                break;
+            }
+        }
+    }
+protected:
+    virtual int_type underflow()
+    {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        QCStMutexLocker locker(mMutex);
+        if (mConsumingFlag) {
+            // Return the buffer to the reader.
+            mConsumingFlag = false;
+            mReadPos       = (mReadPos + 1) % kBufferCount;
+            mFullCount--;
+            mCond.Notify();
+        }
+        while (mFullCount <= 0 && ! mEofFlag) {
+            mCond.Wait(mMutex);
+        }
+        if (mFullCount <= 0) {
+            setg(0, 0, 0);
+            return traits_type::eof();
+        }
+        mConsumingFlag = true;
+        mConsumedFlag  = true;
+        char* const buf = mBuffers[mReadPos];
+        setg(buf, buf, buf + mLengths[mReadPos]);
+        return traits_type::to_int_type(*buf);
+    }
+private:
+    enum { kBufferSize  = 1 << 20 };
+    enum { kBufferCount = 8 };
+
+    mutable QCMutex mMutex;
+    QCCondVar       mCond;
+    QCThread        mThread;
+    int             mFd;
+    int             mError;
+    int64_t         mBytesRead;
+    int             mReadPos;
+    int             mWritePos;
+    int             mFullCount;
+    bool            mConsumingFlag;
+    bool            mConsumedFlag;
+    bool            mEofFlag;
+    bool            mStopFlag;
+    char*           mBuffers[kBufferCount];
+    int             mLengths[kBufferCount];
+private:
+    ReadAhead(const ReadAhead&);
+    ReadAhead& operator=(const ReadAhead&);
+};
+
+Replay::Replay()
+    : readAhead(*(new ReadAhead())),
+      file(&readAhead),
+      path(),
+      number(-1),
+      lastLogNum(-1),
+      lastLogIntBase(-1),
+      appendToLastLogFlag(false),
+      rollSeeds(0),
+      entriesCount(0),
+      bytesCount(0),
+      replayTimeUsec(0)
+{}
+
+Replay::~Replay()
+{
+    readAhead.Close();
+    delete &readAhead;
+}
+
 Replay replayer;
 
 /*!
@@ -67,12 +310,6 @@ Replay replayer;
 int
 Replay::openlog(const string &p)
 {
-    if (file.is_open()) {
-        file.close();
-    }
-    KFS_LOG_STREAM_INFO <<
-        "open log file: " << p.c_str() <<
-    KFS_LOG_EOM;
     int                     num = -1;
     const string::size_type dot = p.rfind('.');
     if (dot != string::npos) {
@@ -92,13 +329,23 @@ Replay::openlog(const string &p)
         KFS_LOG_EOM;
         return -EINVAL;
     }
-    file.open(p.c_str());
-    if (file.fail()) {
-        const int err = errno;
+    if (num == number && readAhead.IsOpenAtStart(p.c_str())) {
+        // Already opened by the checkpoint restore, keep the data read ahead
+        // while the checkpoint was loading.
+        path = p;
+        return 0;
+    }
+    readAhead.Close();
+    KFS_LOG_STREAM_INFO <<
+        "open log file: " << p.c_str() <<
+    KFS_LOG_EOM;
+    file.clear();
+    const int err = readAhead.Open(p.c_str());
+    if (err != 0) {
         KFS_LOG_STREAM_FATAL <<
-            p << ": " << QCUtils::SysError(err) <<
+            p << ": " << QCUtils::SysError(-err) <<
         KFS_LOG_EOM;
-        return (err > 0 ? -err : (err == 0 ? -1 : err));
+        return err;
     }
     number = num;
     path   = p;
@@ -1003,7 +1250,7 @@ Replay::playlog(bool& lastEntryChecksumFlag)
     mds.Reset();
     mds.SetWriteTrough(true);
 
-    if (! file.is_open()) {
+    if (! readAhead.IsOpen()) {
         //!< no log...so, reset the # to 0.
         number = 0;
         return 0;
@@ -1011,6 +1258,7 @@ Replay::playlog(bool& lastEntryChecksumFlag)
 
     DiskEntry& entrymap = get_entry_map();
     DETokenizer tokenizer(file);
+    const int64_t startTime = microseconds();
 
     seq_t opcount = oplog.checkpointed();
     int status = 0;
@@ -1044,18 +1292,35 @@ Replay::playlog(bool& lastEntryChecksumFlag)
     }
     opcount += tokenizer.getEntryCount();
     oplog.set_seqno(opcount);
-    if (status == 0 && ! file.eof()) {
+    const int readErr = readAhead.GetError();
+    if (status == 0 && (readErr != 0 || ! file.eof())) {
         KFS_LOG_STREAM_FATAL <<
             "error " << path <<
             ":" << tokenizer.getEntryCount() <<
             ":" << tokenizer.getEntry() <<
+            (readErr != 0 ? ": " : "") <<
+            (readErr != 0 ? QCUtils::SysError(readErr) : string()) <<
         KFS_LOG_EOM;
         status = -EIO;
     }
     if (status == 0) {
         lastLogIntBase = tokenizer.getIntBase();
     }
-    file.close();
+    const int64_t bytes   = readAhead.GetBytesRead();
+    const int64_t entries = (int64_t)tokenizer.getEntryCount();
+    const int64_t elapsed = max(int64_t(1), microseconds() - startTime);
+    readAhead.Close();
+    entriesCount   += entries;
+    bytesCount     += bytes;
+    replayTimeUsec += elapsed;
+    KFS_LOG_STREAM_INFO <<
+        "replayed: " << path <<
+        " entries: " << entries <<
+        " bytes: "   << bytes <<
+        " time: "    << elapsed * 1e-6 << " sec." <<
+        " entries/sec: " << entries * 1e6 / elapsed <<
+        " bytes/sec: "   << bytes * 1e6 / elapsed <<
+    KFS_LOG_EOM;
     return status;
 }
 
@@ -1085,6 +1350,10 @@ Replay::playLogs(int last, bool includeLastLogFlag)
     lastLineChecksumFlag       = false;
     lastLogIntBase             = -1;
     bool lastEntryChecksumFlag = false;
+    entriesCount               = 0;
+    bytesCount                 = 0;
+    replayTimeUsec             = 0;
+    const int first            = number;
     int i;
     for (i = number; ; i++) {
         if (! includeLastLogFlag && last < i) {
@@ -1132,6 +1401,18 @@ Replay::playLogs(int last, bool includeLastLogFlag)
     } else {
         appendToLastLogFlag = false;
     }
+    KFS_LOG_STREAM(status == 0 ?
+            MsgLogger::kLogLevelINFO : MsgLogger::kLogLevelERROR) <<
+        "replay logs: [" << first << "," << i << ")"
+        " status: "  << status <<
+        " entries: " << entriesCount <<
+        " bytes: "   << bytesCount <<
+        " time: "    << replayTimeUsec * 1e-6 << " sec." <<
+        " entries/sec: " <<
+            entriesCount * 1e6 / max(int64_t(1), replayTimeUsec) <<
+        " bytes/sec: "   <<
+            bytesCount * 1e6 / max(int64_t(1), replayTimeUsec) <<
+    KFS_LOG_EOM;
     return status;
 }
 
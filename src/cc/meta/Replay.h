@@ -26,27 +26,20 @@
 #define KFS_REPLAY_H
 
 #include <string>
-#include <fstream>
+#include <istream>
+
+#include <inttypes.h>
 
 namespace KFS
 {
 using std::string;
-using std::ifstream;
+using std::istream;
 
 class Replay
 {
 public:
-    Replay()
-        : file(),
-          path(),
-          number(-1),
-          lastLogNum(-1),
-          lastLogIntBase(-1),
-          appendToLastLogFlag(false),
-          rollSeeds(0)
-        {}
-    ~Replay()
-        {}
+    Replay();
+    ~Replay();
     bool verifyLogSegmentsPresent()
     {
         lastLogNum = -1;
@@ -65,13 +58,19 @@ public:
     inline void setRollSeeds(int64_t roll);
     int64_t getRollSeeds() const { return rollSeeds; }
 private:
-    ifstream file;   //!< the log file being replayed
-    string   path;   //!< path name for log file
-    int      number; //!< sequence number for log file
-    int      lastLogNum;
-    int      lastLogIntBase;
-    bool     appendToLastLogFlag;
-    int64_t  rollSeeds;
+    class ReadAhead;
+
+    ReadAhead& readAhead; //!< log file reader thread
+    istream    file;      //!< the log file being replayed
+    string     path;      //!< path name for log file
+    int        number;    //!< sequence number for log file
+    int        lastLogNum;
+    int        lastLogIntBase;
+    bool       appendToLastLogFlag;
+    int64_t    rollSeeds;
+    int64_t    entriesCount;
+    int64_t    bytesCount;
+    int64_t    replayTimeUsec;
 
     int playLogs(int lastlog, bool includeLastLogFlag);
     int playlog(bool& lastEntryChecksumFlag);
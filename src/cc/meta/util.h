@@ -114,6 +114,9 @@ public:
         const char* const p = IntToHexString(val, mBufEnd);
         Write(p, mBufEnd - p);
     }
+    template<size_t N>
+    void WriteLiteral(const char (&str)[N])
+        { Write(str, N - 1); }
 private:
     enum { kBufSize = 32 };
 
@@ -76,6 +76,9 @@ public:
           mPendingCloseHeadPtr(0),
           mPendingCloseTailPtr(0),
           mPendingCount(0),
+          mLowPriorityPendingCount(0),
+          mLowPriorityWeight(0),
+          mLowPriorityBypassCount(0),
           mFreeCount(0),
           mTotalCount(0),
           mThreadCount(0),
@@ -138,7 +141,8 @@ public:
         int            inBufferCount,
         IoCompletion*  inIoCompletionPtr,
         Time           inTimeWaitNanoSec,
-        int64_t        inEofHint);
+        int64_t        inEofHint,
+        bool           inLowPriorityFlag);
     bool Cancel(
         RequestId inRequestId);
     IoCompletion* CancelOrSetCompletionIfInFlight(
@@ -156,6 +160,17 @@ public:
         outReadBlockCount   = mPendingReadBlockCount;
         outWriteBlockCount  = mPendingWriteBlockCount;
     }
+    int GetLowPriorityPendingCount()
+    {
+        QCStMutexLocker theLocker(mMutex);
+        return mLowPriorityPendingCount;
+    }
+    void SetLowPriorityWeight(
+        int inWeight)
+    {
+        QCStMutexLocker theLocker(mMutex);
+        mLowPriorityWeight = inWeight;
+    }
     OpenFileStatus OpenFile(
         const char* inFileNamePtr,
         int64_t     inMaxFileSize,
@@ -254,6 +269,7 @@ private:
               mReqType(kReqTypeNone),
               mInFlightFlag(false),
               mFreeBuffersIfNoIoCompletionFlag(false),
+              mLowPriorityFlag(false),
               mBufferCount(0),
               mFileIdx(0),
               mBlockIdx(0),
@@ -270,6 +286,7 @@ private:
         ReqType       mReqType:8;
         bool          mInFlightFlag:1;
         bool          mFreeBuffersIfNoIoCompletionFlag:1;
+        bool          mLowPriorityFlag:1;
         int           mBufferCount;
         uint64_t      mFileIdx:16;
         uint64_t      mBlockIdx:48;
@@ -455,6 +472,9 @@ private:
     unsigned int*      mPendingCloseHeadPtr;
     unsigned int*      mPendingCloseTailPtr;
     int                mPendingCount;
+    int                mLowPriorityPendingCount;
+    int                mLowPriorityWeight;
+    int                mLowPriorityBypassCount;
     int                mFreeCount;
     int                mTotalCount;
     int                mThreadCount;
@@ -610,6 +630,7 @@ private:
         mFreeCount += GetReqListSize(inReq);
         inReq.mReqType         = kReqTypeNone;
         inReq.mInFlightFlag    = false;
+        inReq.mLowPriorityFlag = false;
         inReq.mIoCompletionPtr = 0;
         inReq.mBufferCount     = 0;
         Insert(mRequestsPtr[kFreeQueueIdx], inReq);
@@ -663,7 +684,37 @@ private:
         int      inThreadIdx)
     {
         Trace("enqueue", inReq);
-        Insert(mRequestsPtr[kIoQueueIdx + inThreadIdx], inReq);
+        Request& theHead = mRequestsPtr[kIoQueueIdx + inThreadIdx];
+        Request* theBeforePtr = &theHead;
+        if (inReq.mLowPriorityFlag) {
+            mLowPriorityPendingCount++;
+        } else if (0 < mLowPriorityWeight && 0 < mLowPriorityPendingCount) {
+            // Move ahead of the low priority requests queued at the tail,
+            // but not ahead of barriers, normal priority, or requests to the
+            // same file. Let one low priority request through after
+            // mLowPriorityWeight normal priority requests passed.
+            RequestIdx theIdx = theHead.mPrevIdx;
+            while (&theHead != mRequestsPtr + theIdx) {
+                Request& theReq = mRequestsPtr[theIdx];
+                if (theReq.mReqType != kReqTypeNone) {
+                    if (! theReq.mLowPriorityFlag || theReq.IsBarrier() ||
+                            theReq.mFileIdx == inReq.mFileIdx) {
+                        break;
+                    }
+                    theBeforePtr = &theReq;
+                }
+                theIdx = theReq.mPrevIdx;
+            }
+            if (theBeforePtr != &theHead) {
+                if (mLowPriorityWeight <= mLowPriorityBypassCount) {
+                    mLowPriorityBypassCount = 0;
+                    theBeforePtr = &theHead;
+                } else {
+                    mLowPriorityBypassCount++;
+                }
+            }
+        }
+        Insert(*theBeforePtr, inReq);
         mPendingCount++;
         mFilePendingReqCountPtr[inReq.mFileIdx]++;
         if (inReq.mReqType == kReqTypeRead) {
@@ -691,6 +742,9 @@ private:
         // buffer count larger than request max buffers per request.
         int      theBufCount = inReq.mBufferCount;
         Request* theNextPtr  = mRequestsPtr + inReq.mNextIdx;
+        if (inReq.mLowPriorityFlag) {
+            mLowPriorityPendingCount--;
+        }
         Remove(inReq);
         while ((theBufCount -= mRequestBufferCount) > 0) {
             Request& theReq = *theNextPtr;
@@ -1214,7 +1268,8 @@ QCDiskQueue::Queue::Enqueue(
     int                         inBufferCount,
     QCDiskQueue::IoCompletion*  inIoCompletionPtr,
     QCDiskQueue::Time           inTimeWaitNanoSec,
-    int64_t                     inEofHint)
+    int64_t                     inEofHint,
+    bool                        inLowPriorityFlag)
 {
     if ((inReqType != kReqTypeRead && ! IsWriteReqType(inReqType)) ||
             inBufferCount <= 0 ||
@@ -1287,6 +1342,7 @@ QCDiskQueue::Queue::Enqueue(
         mFileInfoPtr[inFileIdx].mCloseFileSize = inEofHint;
     }
     const int theThreadIdx = mFileInfoPtr[inFileIdx].mThreadIdx;
+    theReq.mLowPriorityFlag = inLowPriorityFlag;
     Enqueue(theReq, theThreadIdx);
     if (! mBarrierFlag) {
         Notify(theThreadIdx);
@@ -2521,7 +2577,8 @@ QCDiskQueue::Enqueue(
     int                         inBufferCount,
     QCDiskQueue::IoCompletion*  inIoCompletionPtr,
     QCDiskQueue::Time           inTimeWaitNanoSec,
-    int64_t                     inEofHint)
+    int64_t                     inEofHint,
+    bool                        inLowPriorityFlag)
 {
     if (! mQueuePtr) {
         return EnqueueStatus(kRequestIdNone, kErrorParameter);
@@ -2534,7 +2591,8 @@ QCDiskQueue::Enqueue(
         inBufferCount,
         inIoCompletionPtr,
         inTimeWaitNanoSec,
-        inEofHint);
+        inEofHint,
+        inLowPriorityFlag);
 }
 
     bool
@@ -2571,6 +2629,21 @@ QCDiskQueue::GetPendingCount(
     }
 }
 
+    int
+QCDiskQueue::GetLowPriorityPendingCount()
+{
+    return (mQueuePtr ? mQueuePtr->GetLowPriorityPendingCount() : 0);
+}
+
+    void
+QCDiskQueue::SetLowPriorityWeight(
+    int inWeight)
+{
+    if (mQueuePtr) {
+        mQueuePtr->SetLowPriorityWeight(inWeight);
+    }
+}
+
     QCDiskQueue::CompletionStatus
 QCDiskQueue::SyncIo(
     QCDiskQueue::ReqType         inReqType,
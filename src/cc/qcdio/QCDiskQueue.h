@@ -328,7 +328,8 @@ public:
         int            inBufferCount,
         IoCompletion*  inIoCompletionPtr,
         Time           inTimeWaitNanoSec = -1,
-        int64_t        inEofHint         = -1);
+        int64_t        inEofHint         = -1,
+        bool           inLowPriorityFlag = false);
 
     EnqueueStatus Read(
         FileIdx        inFileIdx,
@@ -336,7 +337,8 @@ public:
         InputIterator* inBufferIteratorPtr,
         int            inBufferCount,
         IoCompletion*  inIoCompletionPtr,
-        Time           inTimeWaitNanoSec = -1)
+        Time           inTimeWaitNanoSec = -1,
+        bool           inLowPriorityFlag = false)
     {
         return Enqueue(
             kReqTypeRead,
@@ -345,7 +347,9 @@ public:
             inBufferIteratorPtr,
             inBufferCount,
             inIoCompletionPtr,
-            inTimeWaitNanoSec);
+            inTimeWaitNanoSec,
+            -1,
+            inLowPriorityFlag);
     }
 
     EnqueueStatus Write(
@@ -356,7 +360,8 @@ public:
         IoCompletion*  inIoCompletionPtr,
         Time           inTimeWaitNanoSec = -1,
         bool           inSyncFlag        = false,
-        int64_t        inEofHint         = -1)
+        int64_t        inEofHint         = -1,
+        bool           inLowPriorityFlag = false)
     {
         return Enqueue(
             inSyncFlag ? kReqTypeWriteSync : kReqTypeWrite,
@@ -366,7 +371,8 @@ public:
             inBufferCount,
             inIoCompletionPtr,
             inTimeWaitNanoSec,
-            inEofHint);
+            inEofHint,
+            inLowPriorityFlag);
     }
 
     CompletionStatus SyncIo(
@@ -428,6 +434,13 @@ public:
         int64_t& outReadBlockCount,
         int64_t& outWriteBlockCount);
 
+    int GetLowPriorityPendingCount();
+
+    // Normal priority request can be queued ahead of low priority requests
+    // for the same thread, up to inWeight times in a row. 0 -- fifo.
+    void SetLowPriorityWeight(
+        int inWeight);
+
     OpenFileStatus OpenFile(
         const char* inFileNamePtr,
         int64_t     inMaxFileSize           = -1,
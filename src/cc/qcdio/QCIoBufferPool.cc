@@ -33,6 +33,68 @@
 #include <sys/mman.h>
 #include <errno.h>
 #include <unistd.h>
+#ifdef QC_OS_NAME_LINUX
+#include <sys/syscall.h>
+#include <sched.h>
+#endif
+
+#if defined(QC_OS_NAME_LINUX) && defined(SYS_mbind) && defined(SYS_getcpu)
+#define QC_IO_BUFFER_POOL_NUMA
+#endif
+
+static int
+QCNumaBind(
+    void*  inPtr,
+    size_t inSize,
+    int    inNode)
+{
+#ifdef QC_IO_BUFFER_POOL_NUMA
+    if (inNode < 0 || (int)(sizeof(unsigned long) * 8) <= inNode) {
+        return EINVAL;
+    }
+    const int           kMpolPreferred = 1;
+    const unsigned long theMask        = 1UL << inNode;
+    if (syscall(SYS_mbind, inPtr, (unsigned long)inSize, kMpolPreferred,
+            &theMask, (unsigned long)(sizeof(theMask) * 8), 0) != 0) {
+        const int theRet = errno;
+        return (theRet == 0 ? -1 : theRet);
+    }
+    return 0;
+#else
+    (void)inPtr;
+    (void)inSize;
+    (void)inNode;
+    return ENOSYS;
+#endif
+}
+
+static int
+QCGetCurrentNumaNode()
+{
+#ifdef QC_IO_BUFFER_POOL_NUMA
+    // sched_getcpu() is normally serviced by vdso, and does not enter the
+    // kernel. Use getcpu system call to get the node only when the thread
+    // migrates to a different cpu, which should be rare with pinned threads.
+    static __thread int sCpu  = -1;
+    static __thread int sNode = -1;
+    const int theCpu = sched_getcpu();
+    if (theCpu < 0) {
+        return -1;
+    }
+    if (theCpu != sCpu) {
+        unsigned int theCurCpu  = 0;
+        unsigned int theCurNode = 0;
+        if (syscall(SYS_getcpu, &theCurCpu, &theCurNode, (void*)0) != 0) {
+            return -1;
+        }
+        sCpu  = (int)theCurCpu;
+        sNode = (int)theCurNode;
+    }
+    return sNode;
+#else
+    return -1;
+#endif
+}
 
 class QCIoBufferPool::Partition
 {
@@ -44,7 +106,8 @@ public:
           mFreeListPtr(0),
           mTotalCnt(0),
           mFreeCnt(0),
-          mBufSizeShift(0)
+          mBufSizeShift(0),
+          mNumaNode(-1)
         { List::Init(*this); }
 
     ~Partition()
@@ -53,7 +116,8 @@ public:
     int Create(
         int  inNumBuffers,
         int  inBufferSize,
-        bool inLockMemoryFlag)
+        bool inLockMemoryFlag,
+        int  inNumaNode)
     {
         int theBufSizeShift = -1;
         for (int i = inBufferSize; i > 0; i >>= 1, theBufSizeShift++)
@@ -79,6 +143,15 @@ public:
             mAllocPtr = 0;
             return (theRet == 0 ? -1 : theRet);
         }
+        // Bind before the pages are touched by mlock or by the first use.
+        if (0 <= inNumaNode) {
+            const int theRet = QCNumaBind(mAllocPtr, mAllocSize, inNumaNode);
+            if (theRet != 0) {
+                Destroy();
+                return theRet;
+            }
+            mNumaNode = inNumaNode;
+        }
         if (inLockMemoryFlag && mlock(mAllocPtr, mAllocSize) != 0) {
             const int theRet = errno;
             Destroy();
@@ -111,6 +184,7 @@ public:
         mTotalCnt     = 0;
         mFreeCnt      = 0;
         mBufSizeShift = 0;
+        mNumaNode     = -1;
     }
 
     char* Get()
@@ -156,6 +230,9 @@ public:
     bool IsFull() const
         { return (mFreeCnt >= mTotalCnt); }
 
+    int GetNumaNode() const
+        { return mNumaNode; }
+
     typedef QCDLList<Partition, 0> List;
 
 private:
@@ -170,6 +247,7 @@ private:
     int          mTotalCnt;
     int          mFreeCnt;
     int          mBufSizeShift;
+    int          mNumaNode;
     Partition*   mPrevPtr[1];
     Partition*   mNextPtr[1];
 };
@@ -192,7 +270,9 @@ QCIoBufferPool::QCIoBufferPool()
     : mMutex(),
       mBufferSize(0),
       mFreeCnt(0),
-      mTotalCnt(0)
+      mTotalCnt(0),
+      mNumaNodeCount(0),
+      mRemoteNodeGetCount(0)
 {
     QCIoBufferPoolClientList::Init(mClientListPtr);
     Partition::List::Init(mPartitionListPtr);
@@ -215,17 +295,20 @@ QCIoBufferPool::Create(
     int          inPartitionCount,
     int          inPartitionBufferCount,
     int          inBufferSize,
-    bool         inLockMemoryFlag)
+    bool         inLockMemoryFlag,
+    int          inNumaNodeCount /* = 0 */)
 {
     QCStMutexLocker theLock(mMutex);
     Destroy();
-    mBufferSize = inBufferSize;
+    mBufferSize    = inBufferSize;
+    mNumaNodeCount = inNumaNodeCount > 1 ? inNumaNodeCount : 0;
     int theErr = 0;
     for (int i = 0; i < inPartitionCount; i++) {
         Partition& thePart = *(new Partition());
         Partition::List::PushBack(mPartitionListPtr, thePart);
         theErr = thePart.Create(
-            inPartitionBufferCount, inBufferSize, inLockMemoryFlag);
+            inPartitionBufferCount, inBufferSize, inLockMemoryFlag,
+            0 < mNumaNodeCount ? i % mNumaNodeCount : -1);
         if (theErr) {
             Destroy();
             break;
@@ -244,31 +327,58 @@ QCIoBufferPool::Destroy()
     while ((thePtr = Partition::List::PopBack(mPartitionListPtr))) {
         delete thePtr;
     }
-    mBufferSize = 0;
-    mFreeCnt    = 0;
+    mBufferSize    = 0;
+    mFreeCnt       = 0;
+    mNumaNodeCount = 0;
 }
 
 char*
 QCIoBufferPool::Get(
     QCIoBufferPool::RefillReqId inRefillReqId /* = kRefillReqIdUndefined */)
 {
+    // Node count only changes in Create() and Destroy(), get the current
+    // node prior to acquiring the mutex.
+    const int theNode = 0 < mNumaNodeCount ? QCGetCurrentNumaNode() : -1;
     QCStMutexLocker theLock(mMutex);
     if (mFreeCnt <= 0 && ! TryToRefill(inRefillReqId, 1)) {
         return 0;
     }
     QCASSERT(mFreeCnt >= 1);
-    // Always start from the first partition, to try to keep next
-    // partitions full, and be able to reclaim these if needed.
-    Partition::List::Iterator theItr(mPartitionListPtr);
-    Partition* thePtr;
-    while ((thePtr = theItr.Next()) && thePtr->IsEmpty())
-        {}
+    Partition* const thePtr = GetPartition(theNode);
     char* const theBufPtr = thePtr ? thePtr->Get() : 0;
     QCASSERT(theBufPtr && mFreeCnt > 0);
     mFreeCnt--;
+    if (0 <= theNode && thePtr->GetNumaNode() != theNode) {
+        mRemoteNodeGetCount++;
+    }
     return theBufPtr;
 }
 
+QCIoBufferPool::Partition*
+QCIoBufferPool::GetPartition(
+    int inNumaNode)
+{
+    QCASSERT(mMutex.IsOwned());
+    // Always start from the first partition, to try to keep next
+    // partitions full, and be able to reclaim these if needed.
+    // Prefer partitions on the specified numa node, if any.
+    Partition::List::Iterator theItr(mPartitionListPtr);
+    Partition* thePtr;
+    Partition* theRemotePtr = 0;
+    while ((thePtr = theItr.Next())) {
+        if (thePtr->IsEmpty()) {
+            continue;
+        }
+        if (inNumaNode < 0 || thePtr->GetNumaNode() == inNumaNode) {
+            return thePtr;
+        }
+        if (! theRemotePtr) {
+            theRemotePtr = thePtr;
+        }
+    }
+    return theRemotePtr;
+}
+
 bool
 QCIoBufferPool::Get(
     QCIoBufferPool::OutputIterator& inIt,
@@ -278,21 +388,23 @@ QCIoBufferPool::Get(
     if (inBufCnt <= 0) {
         return true;
     }
+    const int theNode = 0 < mNumaNodeCount ? QCGetCurrentNumaNode() : -1;
     QCStMutexLocker theLock(mMutex);
     if (mFreeCnt < inBufCnt && ! TryToRefill(inRefillReqId, inBufCnt)) {
         return false;
     }
     QCASSERT(mFreeCnt >= inBufCnt);
-    Partition::List::Iterator theItr(mPartitionListPtr);
     for (int i = 0; i < inBufCnt; ) {
-        Partition* thePPtr;
-        while ((thePPtr = theItr.Next()) && thePPtr->IsEmpty())
-            {}
+        Partition* const thePPtr = GetPartition(theNode);
         QCASSERT(thePPtr);
+        const int theStart = i;
         for (char* theBPtr; i < inBufCnt && (theBPtr = thePPtr->Get()); i++) {
             mFreeCnt--;
             inIt.Put(theBPtr);
         }
+        if (0 <= theNode && thePPtr->GetNumaNode() != theNode) {
+            mRemoteNodeGetCount += i - theStart;
+        }
     }
     return true;
 }
@@ -409,3 +521,10 @@ QCIoBufferPool::GetUsedBufferCount()
     QCStMutexLocker theLock(mMutex);
     return (mTotalCnt - mFreeCnt);
 }
+
+int64_t
+QCIoBufferPool::GetRemoteNodeGetCount()
+{
+    QCStMutexLocker theLock(mMutex);
+    return mRemoteNodeGetCount;
+}
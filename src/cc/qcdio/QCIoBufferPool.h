@@ -103,7 +103,8 @@ public:
         int          inPartitionCount,
         int          inPartitionBufferCount,
         int          inBufferSize,
-        bool         inLockMemoryFlag);
+        bool         inLockMemoryFlag,
+        int          inNumaNodeCount = 0);
     void Destroy();
     char* Get(
         RefillReqId inRefillReqId = kRefillReqIdUndefined);
@@ -125,6 +126,9 @@ public:
     int GetFreeBufferCount();
     int GetTotalBufferCount();
     int GetUsedBufferCount();
+    // Number of buffers allocated from partitions on numa node different from
+    // the node of the calling thread's cpu.
+    int64_t GetRemoteNodeGetCount();
 
 private:
     class Partition;
@@ -134,7 +138,11 @@ private:
     int        mBufferSize;
     int        mFreeCnt;
     int        mTotalCnt;
+    int        mNumaNodeCount;
+    int64_t    mRemoteNodeGetCount;
 
+    Partition* GetPartition(
+        int inNumaNode);
     bool TryToRefill(
         RefillReqId inReqId,
         int         inBufCnt);
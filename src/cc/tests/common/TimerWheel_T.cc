@@ -0,0 +1,202 @@
+//---------------------------------------------------------- -*- Mode: C++ -*-
+// $Id$
+//
+// Copyright 2026 Quantcast Corporation. All rights reserved.
+//
+// This file is part of Kosmos File System (KFS).
+//
+// Licensed under the Apache License, Version 2.0
+// (the "License"); you may not use this file except in compliance with
+// the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// \file TimerWheel_T.cc
+// \brief Timer wheel unit tests.
+//
+//----------------------------------------------------------------------------
+
+#include "common/TimerWheel.h"
+#include "qcdio/QCDLList.h"
+
+#include <gtest/gtest.h>
+
+#include <stdlib.h>
+#include <inttypes.h>
+
+namespace KFS
+{
+namespace Test
+{
+
+class TimerWheelEntry
+{
+public:
+    typedef QCDLListOp<TimerWheelEntry> List;
+
+    TimerWheelEntry()
+        : mExpires(-1),
+          mFiredTime(-1)
+        { List::Init(*this); }
+    int64_t mExpires;
+    int64_t mFiredTime;
+private:
+    TimerWheelEntry* mPrevPtr[1];
+    TimerWheelEntry* mNextPtr[1];
+
+    friend class QCDLListOp<TimerWheelEntry>;
+};
+
+enum { kBucketCount = 64 };
+enum { kResolution  = 4 };
+typedef TimerWheel<
+    TimerWheelEntry,
+    TimerWheelEntry::List,
+    int64_t,
+    kBucketCount,
+    kResolution
+> TestTimerWheel;
+
+// Re-schedules not yet expired entries, the same way as NetManager does for
+// timeouts that exceed the wheel span.
+class TimerWheelExpire
+{
+public:
+    TimerWheelExpire(
+        TestTimerWheel& inWheel,
+        int64_t         inNow)
+        : mWheel(inWheel),
+          mNow(inNow),
+          mFiredCount(0)
+        {}
+    void operator()(
+        TimerWheelEntry& inEntry)
+    {
+        if (mNow < inEntry.mExpires) {
+            mWheel.Schedule(inEntry, inEntry.mExpires);
+            return;
+        }
+        TimerWheelEntry::List::Remove(inEntry);
+        inEntry.mFiredTime = mNow;
+        mFiredCount++;
+    }
+    int GetFiredCount() const
+        { return mFiredCount; }
+private:
+    TestTimerWheel& mWheel;
+    const int64_t   mNow;
+    int             mFiredCount;
+};
+
+class TimerWheelCount
+{
+public:
+    TimerWheelCount()
+        : mCount(0)
+        {}
+    void operator()(
+        const TimerWheelEntry& /* inEntry */)
+        { mCount++; }
+    int mCount;
+};
+
+TEST(TimerWheelTest, FiresWithinResolutionAfterExpiration)
+{
+    const int64_t  kStart = 1000;
+    const int      kCount = 2000;
+    const int64_t  kSpan  = 3 * kBucketCount * kResolution;
+    TestTimerWheel theWheel(kStart);
+    TimerWheelEntry theEntries[kCount];
+    srand(1);
+    for (int i = 0; i < kCount; i++) {
+        theEntries[i].mExpires = kStart + rand() % kSpan;
+        theWheel.Schedule(theEntries[i], theEntries[i].mExpires);
+    }
+    int theFiredCount = 0;
+    for (int64_t theNow = kStart; theNow <= kStart + kSpan + kResolution;
+            theNow++) {
+        TimerWheelExpire theExpire(theWheel, theNow);
+        theWheel.Run(theNow, theExpire);
+        theFiredCount += theExpire.GetFiredCount();
+    }
+    ASSERT_EQ(kCount, theFiredCount);
+    for (int i = 0; i < kCount; i++) {
+        const TimerWheelEntry& theEntry = theEntries[i];
+        EXPECT_LE(theEntry.mExpires, theEntry.mFiredTime);
+        EXPECT_GT(theEntry.mExpires + kResolution, theEntry.mFiredTime);
+    }
+}
+
+TEST(TimerWheelTest, NextRunTime)
+{
+    const int64_t  kStart = 5000;
+    TestTimerWheel theWheel(kStart);
+    const int64_t  kMaxTime = kStart + 10 * kBucketCount * kResolution;
+    EXPECT_EQ(kMaxTime, theWheel.GetNextRunTime(kStart, kMaxTime));
+    for (int64_t theTimeout = 0;
+            theTimeout < (kBucketCount - 1) * kResolution;
+            theTimeout++) {
+        int64_t         theNow = kStart + theTimeout * 7;
+        TimerWheelEntry theEntry;
+        theEntry.mExpires = theNow + theTimeout;
+        theWheel.Schedule(theEntry, theEntry.mExpires);
+        const int64_t theRunTime = theWheel.GetNextRunTime(theNow, kMaxTime);
+        EXPECT_LE(theEntry.mExpires, theRunTime);
+        EXPECT_GT(theEntry.mExpires + kResolution, theRunTime);
+        // Run with the time just before the returned time must not fire
+        // the entry.
+        if (theNow < theRunTime) {
+            TimerWheelExpire theExpire(theWheel, theRunTime - 1);
+            theWheel.Run(theRunTime - 1, theExpire);
+            EXPECT_EQ(0, theExpire.GetFiredCount());
+        }
+        TimerWheelExpire theExpire(theWheel, theRunTime);
+        theWheel.Run(theRunTime, theExpire);
+        EXPECT_EQ(1, theExpire.GetFiredCount());
+        EXPECT_EQ(theRunTime, theEntry.mFiredTime);
+        EXPECT_EQ(kMaxTime, theWheel.GetNextRunTime(theRunTime, kMaxTime));
+    }
+}
+
+TEST(TimerWheelTest, CancelAndApply)
+{
+    const int64_t  kStart = 0;
+    const int      kCount = 100;
+    TestTimerWheel theWheel(kStart);
+    TimerWheelEntry theEntries[kCount];
+    for (int i = 0; i < kCount; i++) {
+        theEntries[i].mExpires = kStart + i * kResolution;
+        theWheel.Schedule(theEntries[i], theEntries[i].mExpires);
+    }
+    TimerWheelCount theCount;
+    theWheel.Apply(theCount);
+    EXPECT_EQ(kCount, theCount.mCount);
+    // Cancel every other entry.
+    for (int i = 0; i < kCount; i += 2) {
+        TimerWheelEntry::List::Remove(theEntries[i]);
+    }
+    TimerWheelCount theRemaining;
+    theWheel.Apply(theRemaining);
+    EXPECT_EQ(kCount / 2, theRemaining.mCount);
+    int theFiredCount = 0;
+    for (int64_t theNow = kStart;
+            theNow <= kStart + (kCount + 1) * kResolution;
+            theNow++) {
+        TimerWheelExpire theExpire(theWheel, theNow);
+        theWheel.Run(theNow, theExpire);
+        theFiredCount += theExpire.GetFiredCount();
+    }
+    EXPECT_EQ(kCount / 2, theFiredCount);
+    for (int i = 0; i < kCount; i++) {
+        EXPECT_EQ(i % 2 != 0, 0 <= theEntries[i].mFiredTime);
+    }
+}
+
+} // namespace Test
+} // namespace KFS
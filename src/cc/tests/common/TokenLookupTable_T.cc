@@ -0,0 +1,129 @@
+//---------------------------------------------------------- -*- Mode: C++ -*-
+// $Id$
+//
+// Copyright 2026 Quantcast Corporation. All rights reserved.
+//
+// This file is part of Kosmos File System (KFS).
+//
+// Licensed under the Apache License, Version 2.0
+// (the "License"); you may not use this file except in compliance with
+// the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// \file TokenLookupTable_T.cc
+// \brief Request parser token lookup table unit tests.
+//
+//----------------------------------------------------------------------------
+
+#include "common/RequestParser.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+
+namespace KFS
+{
+namespace Test
+{
+using std::map;
+using std::string;
+using std::vector;
+
+typedef TokenLookupTable<int>             TestTokenTable;
+typedef TestTokenTable::Key               TestToken;
+typedef map<TestToken, int>               TestTokenMap;
+
+static string
+RandomName(
+    int inMaxLen)
+{
+    static const char kChars[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJ-_:";
+    string     theRet;
+    const int  theLen = rand() % (inMaxLen + 1);
+    for (int i = 0; i < theLen; i++) {
+        theRet += kChars[rand() % (int)(sizeof(kChars) - 1)];
+    }
+    return theRet;
+}
+
+TEST(TokenLookupTableTest, EmptyTable)
+{
+    TestTokenTable theTable;
+    EXPECT_TRUE(0 == theTable.Find(TestToken("Cseq")));
+    theTable.Build(TestTokenMap());
+    EXPECT_TRUE(0 == theTable.Find(TestToken("Cseq")));
+    EXPECT_TRUE(0 == theTable.Find(TestToken("")));
+}
+
+TEST(TokenLookupTableTest, HeaderNames)
+{
+    static const char* const kNames[] = {
+        "Cseq", "Version", "Client-Protocol-Version", "Chunk-handle",
+        "Chunk-version", "Offset", "Num-bytes", "Checksum", "Checksum-entries",
+        "File-handle", "Pathname", "Max-entries", "Short-rpc-fmt",
+        "Status", "Status-message", "Content-length", "Max-wait-ms", "C",
+        "H", "V", "O", "B", "K", "Cs", "Cse", "Cseq-"
+    };
+    const int    kCount = (int)(sizeof(kNames) / sizeof(kNames[0]));
+    TestTokenMap theMap;
+    for (int i = 0; i < kCount; i++) {
+        theMap[TestToken(kNames[i])] = i;
+    }
+    TestTokenTable theTable;
+    theTable.Build(theMap);
+    for (int i = 0; i < kCount; i++) {
+        // Lookup with a key that points to a different buffer.
+        const string theName(kNames[i]);
+        const int*   thePtr = theTable.Find(
+            TestToken(theName.data(), theName.size()));
+        ASSERT_TRUE(0 != thePtr);
+        EXPECT_EQ(i, *thePtr);
+    }
+    static const char* const kMissing[] = {
+        "", "cseq", "Cseq ", "Chunk-handl", "Chunk-handlee", "Z", "Statu"
+    };
+    for (size_t i = 0; i < sizeof(kMissing) / sizeof(kMissing[0]); i++) {
+        EXPECT_TRUE(0 == theTable.Find(TestToken(kMissing[i])));
+    }
+}
+
+TEST(TokenLookupTableTest, MatchesMapLookup)
+{
+    srand(1);
+    vector<string> theNames;
+    for (int i = 0; i < 500; i++) {
+        theNames.push_back(RandomName(12));
+    }
+    TestTokenMap theMap;
+    for (size_t i = 0; i < theNames.size(); i++) {
+        theMap[TestToken(theNames[i].data(), theNames[i].size())] = (int)i;
+    }
+    TestTokenTable theTable;
+    theTable.Build(theMap);
+    for (int i = 0; i < 20000; i++) {
+        const string theName = (i % 2) == 0 ?
+            theNames[rand() % theNames.size()] : RandomName(12);
+        const TestToken theKey(theName.data(), theName.size());
+        TestTokenMap::const_iterator const theIt = theMap.find(theKey);
+        const int* const thePtr = theTable.Find(theKey);
+        if (theIt == theMap.end()) {
+            EXPECT_TRUE(0 == thePtr) << theName;
+        } else {
+            ASSERT_TRUE(0 != thePtr) << theName;
+            EXPECT_EQ(theIt->second, *thePtr) << theName;
+        }
+    }
+}
+
+} // namespace Test
+} // namespace KFS
@@ -0,0 +1,222 @@
+//---------------------------------------------------------- -*- Mode: C++ -*-
+// $Id$
+//
+// Copyright 2026 Quantcast Corporation. All rights reserved.
+//
+// This file is part of Kosmos File System (KFS).
+//
+// Licensed under the Apache License, Version 2.0
+// (the "License"); you may not use this file except in compliance with
+// the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// \file WeightTree_T.cc
+// \brief Weight tree unit tests.
+//
+//----------------------------------------------------------------------------
+
+#include "common/WeightTree.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <stdlib.h>
+
+namespace KFS
+{
+namespace Test
+{
+using std::binary_search;
+using std::lower_bound;
+using std::make_pair;
+using std::pair;
+using std::vector;
+
+typedef WeightTree::Weight            TestWeight;
+typedef vector<TestWeight>            TestWeights;
+typedef vector<pair<TestWeight, int> > TestItems;
+typedef vector<size_t>                TestPicked;
+
+static TestWeights
+RandomWeights(
+    size_t     inCount,
+    TestWeight inMaxWeight)
+{
+    TestWeights theRet;
+    for (size_t i = 0; i < inCount; i++) {
+        // Every 4th weight is 0 on average, as with the servers that are not
+        // candidates.
+        theRet.push_back(rand() % 4 == 0 ?
+            TestWeight(0) : TestWeight(rand() % inMaxWeight + 1));
+    }
+    return theRet;
+}
+
+static void
+SetWeights(
+    WeightTree&        inTree,
+    const TestWeights& inWeights)
+{
+    inTree.Resize(inWeights.size());
+    for (size_t i = 0; i < inWeights.size(); i++) {
+        inTree.SetWeight(i, inWeights[i]);
+    }
+}
+
+// The chunk placement linear scan weighted pick, that the weight tree
+// replaces.
+static size_t
+LinearScanPick(
+    const TestWeights& inWeights,
+    TestWeight         inValue)
+{
+    TestWeight theRnd = inValue;
+    for (size_t i = 0; i < inWeights.size(); i++) {
+        if ((theRnd -= inWeights[i]) < 0) {
+            return i;
+        }
+    }
+    return inWeights.size();
+}
+
+TEST(WeightTreeTest, Empty)
+{
+    WeightTree theTree;
+    EXPECT_TRUE(theTree.IsEmpty());
+    EXPECT_EQ(TestWeight(0), theTree.GetSum());
+    EXPECT_EQ(size_t(0), theTree.Find(0));
+    theTree.Resize(5);
+    EXPECT_EQ(size_t(5), theTree.GetSize());
+    EXPECT_EQ(TestWeight(0), theTree.GetSum());
+    EXPECT_EQ(size_t(5), theTree.Find(0));
+}
+
+TEST(WeightTreeTest, FindMatchesLinearScan)
+{
+    srand(1);
+    for (size_t theSize = 1; theSize <= 70; theSize++) {
+        const TestWeights theWeights = RandomWeights(theSize, 5);
+        WeightTree        theTree;
+        SetWeights(theTree, theWeights);
+        TestWeight theSum = 0;
+        for (size_t i = 0; i < theWeights.size(); i++) {
+            EXPECT_EQ(theSum, theTree.GetPrefixSum(i));
+            theSum += theWeights[i];
+        }
+        ASSERT_EQ(theSum, theTree.GetSum());
+        for (TestWeight theValue = 0; theValue <= theSum; theValue++) {
+            EXPECT_EQ(LinearScanPick(theWeights, theValue),
+                theTree.Find(theValue)) << "size: " << theSize <<
+                " value: " << theValue;
+        }
+    }
+}
+
+TEST(WeightTreeTest, BuildMatchesSetWeight)
+{
+    srand(2);
+    for (size_t theSize = 0; theSize <= 100; theSize += 7) {
+        const TestWeights theWeights = RandomWeights(theSize, 1000);
+        TestItems         theItems;
+        for (size_t i = 0; i < theWeights.size(); i++) {
+            theItems.push_back(make_pair(theWeights[i], (int)i));
+        }
+        WeightTree theBuilt;
+        theBuilt.Build(theItems);
+        WeightTree theSet;
+        SetWeights(theSet, theWeights);
+        ASSERT_EQ(theSet.GetSum(), theBuilt.GetSum());
+        for (size_t i = 0; i <= theWeights.size(); i++) {
+            EXPECT_EQ(theSet.GetPrefixSum(i), theBuilt.GetPrefixSum(i));
+        }
+    }
+}
+
+TEST(WeightTreeTest, IncrementalUpdates)
+{
+    srand(3);
+    const size_t kSize    = 257;
+    TestWeights  theWeights(kSize, TestWeight(0));
+    WeightTree   theTree;
+    theTree.Resize(kSize);
+    for (int k = 0; k < 20000; k++) {
+        const size_t     theIdx    = rand() % kSize;
+        const TestWeight theWeight = rand() % 3 == 0 ? 0 : rand() % 100000;
+        theWeights[theIdx] = theWeight;
+        theTree.SetWeight(theIdx, theWeight);
+        EXPECT_EQ(theWeight, theTree.GetWeight(theIdx));
+        if (k % 1000 != 0) {
+            continue;
+        }
+        TestWeight theSum = 0;
+        for (size_t i = 0; i < kSize; i++) {
+            ASSERT_EQ(theSum, theTree.GetPrefixSum(i));
+            theSum += theWeights[i];
+        }
+        ASSERT_EQ(theSum, theTree.GetSum());
+    }
+}
+
+// Weighted selection without replacement with the excluded indices must pick
+// the same items as the linear scan over the remaining items with the same
+// random values, including when the weights change between the picks.
+TEST(WeightTreeTest, WeightedSelectionMatchesLinearScan)
+{
+    srand(4);
+    for (int theRun = 0; theRun < 200; theRun++) {
+        const size_t theSize    = 1 + rand() % 300;
+        TestWeights  theWeights = RandomWeights(theSize, 1 << 20);
+        WeightTree   theTree;
+        SetWeights(theTree, theWeights);
+        TestPicked   thePicked;
+        TestWeights  theRemaining = theWeights;
+        for (; ;) {
+            if (rand() % 4 == 0) {
+                // Weight change, for example on chunk server heartbeat.
+                const size_t     theIdx    = rand() % theSize;
+                const TestWeight theWeight = rand() % (1 << 20);
+                theWeights[theIdx] = theWeight;
+                theTree.SetWeight(theIdx, theWeight);
+                if (! binary_search(
+                        thePicked.begin(), thePicked.end(), theIdx)) {
+                    theRemaining[theIdx] = theWeight;
+                }
+            }
+            TestWeight theSum = theTree.GetSum();
+            for (size_t i = 0; i < thePicked.size(); i++) {
+                theSum -= theTree.GetWeight(thePicked[i]);
+            }
+            TestWeight theRemainingSum = 0;
+            for (size_t i = 0; i < theRemaining.size(); i++) {
+                theRemainingSum += theRemaining[i];
+            }
+            ASSERT_EQ(theRemainingSum, theSum);
+            if (theSum <= 0) {
+                break;
+            }
+            const TestWeight theValue = (TestWeight)(
+                ((uint64_t)rand() << 31 | (uint64_t)rand()) % theSum);
+            const size_t theIdx = theTree.Find(
+                theValue, thePicked.begin(), thePicked.end());
+            ASSERT_EQ(LinearScanPick(theRemaining, theValue), theIdx);
+            ASSERT_LT(theIdx, theSize);
+            ASSERT_LT(TestWeight(0), theRemaining[theIdx]);
+            theRemaining[theIdx] = 0;
+            thePicked.insert(lower_bound(
+                thePicked.begin(), thePicked.end(), theIdx), theIdx);
+        }
+        EXPECT_LE(thePicked.size(), theSize);
+    }
+}
+
+} // namespace Test
+} // namespace KFS
@@ -0,0 +1,261 @@
+//---------------------------------------------------------- -*- Mode: C++ -*-
+// $Id$
+//
+// Copyright 2026 Quantcast Corporation. All rights reserved.
+//
+// This file is part of Kosmos File System (KFS).
+//
+// Licensed under the Apache License, Version 2.0
+// (the "License"); you may not use this file except in compliance with
+// the License. You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the License.
+//
+// \file QCDiskQueue_T.cc
+// \brief Disk queue low priority request bypass ordering unit tests.
+//
+//----------------------------------------------------------------------------
+
+#include "qcdio/QCDiskQueue.h"
+#include "qcdio/QCIoBufferPool.h"
+#include "qcdio/QCMutex.h"
+#include "qcdio/qcstutils.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace KFS
+{
+namespace Test
+{
+using std::string;
+using std::vector;
+
+// Stalls the io thread on the first request, and records the order in which
+// the io thread starts the requests by their start block index.
+class DiskQueueIoTracker :
+    public QCDiskQueue::IoStartObserver,
+    public QCDiskQueue::IoCompletion
+{
+public:
+    DiskQueueIoTracker()
+        : mMutex(),
+          mCond(),
+          mStalledFlag(false),
+          mReleaseFlag(false),
+          mPendingCount(0),
+          mStartedBlocks()
+        {}
+    virtual void Notify(
+        QCDiskQueue::ReqType   /* inReqType */,
+        QCDiskQueue::RequestId /* inRequestId */,
+        QCDiskQueue::FileIdx   /* inFileIdx */,
+        QCDiskQueue::BlockIdx  inStartBlockIdx,
+        int                    /* inBufferCount */)
+    {
+        QCStMutexLocker theLocker(mMutex);
+        mStartedBlocks.push_back(inStartBlockIdx);
+        if (mStalledFlag) {
+            return;
+        }
+        mStalledFlag = true;
+        mCond.NotifyAll();
+        while (! mReleaseFlag) {
+            mCond.Wait(mMutex);
+        }
+    }
+    virtual bool Done(
+        QCDiskQueue::RequestId      /* inRequestId */,
+        QCDiskQueue::FileIdx        /* inFileIdx */,
+        QCDiskQueue::BlockIdx       /* inStartBlockIdx */,
+        QCDiskQueue::InputIterator& /* inBufferItr */,
+        int                         /* inBufferCount */,
+        QCDiskQueue::Error          /* inCompletionCode */,
+        int                         /* inSysErrorCode */,
+        int64_t                     /* inIoByteCount */)
+    {
+        QCStMutexLocker theLocker(mMutex);
+        mPendingCount--;
+        mCond.NotifyAll();
+        return false; // Tell caller to free the buffers.
+    }
+    bool Read(
+        QCDiskQueue&          inQueue,
+        QCDiskQueue::FileIdx  inFileIdx,
+        QCDiskQueue::BlockIdx inBlockIdx,
+        bool                  inLowPriorityFlag)
+    {
+        const QCDiskQueue::EnqueueStatus theStatus = inQueue.Read(
+            inFileIdx, inBlockIdx, 0, 1, this, -1, inLowPriorityFlag);
+        if (theStatus.IsError()) {
+            return false;
+        }
+        QCStMutexLocker theLocker(mMutex);
+        mPendingCount++;
+        return true;
+    }
+    void WaitStalled()
+    {
+        QCStMutexLocker theLocker(mMutex);
+        while (! mStalledFlag) {
+            mCond.Wait(mMutex);
+        }
+    }
+    vector<QCDiskQueue::BlockIdx> ReleaseAndWait()
+    {
+        QCStMutexLocker theLocker(mMutex);
+        mReleaseFlag = true;
+        mCond.NotifyAll();
+        while (0 < mPendingCount) {
+            mCond.Wait(mMutex);
+        }
+        return mStartedBlocks;
+    }
+private:
+    QCMutex                       mMutex;
+    QCCondVar                     mCond;
+    bool                          mStalledFlag;
+    bool                          mReleaseFlag;
+    int                           mPendingCount;
+    vector<QCDiskQueue::BlockIdx> mStartedBlocks;
+};
+
+class DiskQueueBypassTest : public ::testing::Test
+{
+protected:
+    enum { kFileCount  = 3 };
+    enum { kBlockCount = 16 };
+    enum { kBlockSize  = 4 << 10 };
+
+    DiskQueueBypassTest()
+        : mBufferPool(),
+          mQueue(),
+          mTracker(),
+          mFileNames()
+        {}
+    virtual void SetUp()
+    {
+        const char* theFileNames[kFileCount];
+        for (int i = 0; i < kFileCount; i++) {
+            char theName[] = "/tmp/QCDiskQueue_T.XXXXXX";
+            const int theFd = mkstemp(theName);
+            ASSERT_LE(0, theFd);
+            mFileNames.push_back(theName);
+            ASSERT_EQ(0, ftruncate(theFd, (off_t)kBlockCount * kBlockSize));
+            close(theFd);
+        }
+        for (int i = 0; i < kFileCount; i++) {
+            theFileNames[i] = mFileNames[i].c_str();
+        }
+        ASSERT_EQ(0, mBufferPool.Create(1, 4 * kBlockCount, kBlockSize,
+            false));
+        const int  kThreadCount = 1;
+        const int  kQueueDepth  = 4 * kBlockCount;
+        const bool kBufferedIo  = true;
+        ASSERT_EQ(0, mQueue.Start(
+            kThreadCount,
+            kQueueDepth,
+            1,
+            kFileCount,
+            theFileNames,
+            mBufferPool,
+            &mTracker,
+            QCDiskQueue::CpuAffinity::None(),
+            0,
+            kBufferedIo
+        ));
+    }
+    virtual void TearDown()
+    {
+        mQueue.Stop();
+        for (size_t i = 0; i < mFileNames.size(); i++) {
+            unlink(mFileNames[i].c_str());
+        }
+    }
+    // Stall the io thread, so that the subsequent requests remain queued.
+    void Stall()
+    {
+        ASSERT_TRUE(mTracker.Read(mQueue, 0, 0, false));
+        mTracker.WaitStalled();
+    }
+    void Read(
+        QCDiskQueue::FileIdx  inFileIdx,
+        QCDiskQueue::BlockIdx inBlockIdx,
+        bool                  inLowPriorityFlag)
+    {
+        ASSERT_TRUE(mTracker.Read(
+            mQueue, inFileIdx, inBlockIdx, inLowPriorityFlag));
+    }
+    void Expect(
+        const QCDiskQueue::BlockIdx* inOrderPtr,
+        size_t                       inCount)
+    {
+        const vector<QCDiskQueue::BlockIdx> theOrder =
+            mTracker.ReleaseAndWait();
+        EXPECT_EQ(vector<QCDiskQueue::BlockIdx>(
+            inOrderPtr, inOrderPtr + inCount), theOrder);
+        EXPECT_EQ(0, mQueue.GetLowPriorityPendingCount());
+    }
+
+    QCIoBufferPool     mBufferPool;
+    QCDiskQueue        mQueue;
+    DiskQueueIoTracker mTracker;
+    vector<string>     mFileNames;
+};
+
+TEST_F(DiskQueueBypassTest, FifoWithZeroWeight)
+{
+    mQueue.SetLowPriorityWeight(0);
+    Stall();
+    Read(1, 1, true);
+    Read(1, 2, true);
+    Read(2, 3, false);
+    Read(2, 4, false);
+    EXPECT_EQ(2, mQueue.GetLowPriorityPendingCount());
+    const QCDiskQueue::BlockIdx kOrder[] = { 0, 1, 2, 3, 4 };
+    Expect(kOrder, sizeof(kOrder) / sizeof(kOrder[0]));
+}
+
+TEST_F(DiskQueueBypassTest, NormalBypassesLowUpToWeight)
+{
+    mQueue.SetLowPriorityWeight(2);
+    Stall();
+    Read(1, 1, true);
+    Read(1, 2, true);
+    Read(1, 3, true);
+    Read(2, 4, false);
+    Read(2, 5, false);
+    // The third normal priority request in a row goes to the tail, in order
+    // to let the low priority requests through.
+    Read(2, 6, false);
+    Read(2, 7, false);
+    EXPECT_EQ(3, mQueue.GetLowPriorityPendingCount());
+    const QCDiskQueue::BlockIdx kOrder[] = { 0, 4, 5, 1, 2, 3, 6, 7 };
+    Expect(kOrder, sizeof(kOrder) / sizeof(kOrder[0]));
+}
+
+TEST_F(DiskQueueBypassTest, NormalDoesNotBypassSameFile)
+{
+    mQueue.SetLowPriorityWeight(10);
+    Stall();
+    Read(1, 1, true);
+    Read(2, 2, true);
+    Read(1, 3, true);
+    Read(2, 4, false);
+    const QCDiskQueue::BlockIdx kOrder[] = { 0, 1, 2, 4, 3 };
+    Expect(kOrder, sizeof(kOrder) / sizeof(kOrder[0]));
+}
+
+} // namespace Test
+} // namespace KFS
@@ -834,15 +834,18 @@ public:
     {
     public:
         KfsDirIterator(
+            KfsClient*           inClientPtr,
             vector<KfsFileAttr>* inAttrsPtr,
             vector<string>*      inNamesPtr)
-            : mFetchAttributesFlag(inAttrsPtr != 0),
+            : mClientPtr(inClientPtr),
+              mFetchAttributesFlag(inClientPtr != 0 || inAttrsPtr != 0),
+              mCursor(),
               mAttrs(),
               mNames(),
               mCur(0),
               mStatBuf()
         {
-            if (mFetchAttributesFlag) {
+            if (inAttrsPtr) {
                 inAttrsPtr->swap(mAttrs);
             } else if (inNamesPtr) {
                 inNamesPtr->swap(mNames);
@@ -850,35 +853,46 @@ public:
         }
         virtual ~KfsDirIterator()
             {}
-        void Next(
+        KfsClient::DirCursor& GetCursor()
+            { return mCursor; }
+        int Next(
             string&         outName,
             const StatBuf*& outStatBufPtr)
         {
             if (mFetchAttributesFlag) {
-                if (mCur >= mAttrs.size()) {
-                    outStatBufPtr = 0;
-                    outName.clear();
-                    return;
+                if (mAttrs.size() <= mCur) {
+                    mCur = 0;
+                    const int theRet = mClientPtr ?
+                        mClientPtr->NextEntries(mCursor, mAttrs) : 0;
+                    if (theRet <= 0) {
+                        mAttrs.clear();
+                        outStatBufPtr = 0;
+                        outName.clear();
+                        return theRet;
+                    }
                 }
                 const KfsFileAttr& theAttr = mAttrs[mCur++];
                 outName = theAttr.filename;
                 ToStat(theAttr, mStatBuf);
                 outStatBufPtr = &mStatBuf;
-                return;
+                return 0;
             }
             outStatBufPtr = 0;
             if (mCur >= mNames.size()) {
                 outName.clear();
-                return;
+                return 0;
             }
             outName = mNames[mCur++];
+            return 0;
         }
     private:
-        const bool          mFetchAttributesFlag;
-        vector<KfsFileAttr> mAttrs;
-        vector<string>      mNames;
-        size_t              mCur;
-        StatBuf             mStatBuf;
+        KfsClient* const     mClientPtr;
+        const bool           mFetchAttributesFlag;
+        KfsClient::DirCursor mCursor;
+        vector<KfsFileAttr>  mAttrs;
+        vector<string>       mNames;
+        size_t               mCur;
+        StatBuf              mStatBuf;
     };
     KfsFileSystem(
         const string& inUri,
@@ -1076,15 +1090,33 @@ public:
         DirIterator*& outDirIteratorPtr)
     {
         if (inFetchAttributesFlag) {
-            vector<KfsFileAttr> theAttrs;
-            const int theRet = ReaddirPlus(inDirName.c_str(), theAttrs);
-            outDirIteratorPtr =
-                theRet == 0 ? new KfsDirIterator(&theAttrs, 0) : 0;
+            // Stream the directory one meta server response at a time, in
+            // order to keep memory use independent of the directory size.
+            KfsDirIterator* const theItPtr = new KfsDirIterator(this, 0, 0);
+            const int theRet = OpenDir(inDirName.c_str(), theItPtr->GetCursor());
+            if (theRet != 0) {
+                delete theItPtr;
+                outDirIteratorPtr = 0;
+            } else {
+                outDirIteratorPtr = theItPtr;
+            }
             return theRet;
         }
         vector<string> theNames;
         const int theRet  = Readdir(inDirName.c_str(), theNames);
-        outDirIteratorPtr = theRet == 0 ? new KfsDirIterator(0, &theNames) : 0;
+        outDirIteratorPtr =
+            theRet == 0 ? new KfsDirIterator(0, 0, &theNames) : 0;
+        return theRet;
+    }
+    virtual int OpenSorted(
+        const string& inDirName,
+        DirIterator*& outDirIteratorPtr)
+    {
+        // Listing has to be sorted, thus fetch the whole directory.
+        vector<KfsFileAttr> theAttrs;
+        const int theRet  = ReaddirPlus(inDirName.c_str(), theAttrs);
+        outDirIteratorPtr =
+            theRet == 0 ? new KfsDirIterator(0, &theAttrs, 0) : 0;
         return theRet;
     }
     virtual int Close(
@@ -1107,8 +1139,7 @@ public:
             return -EINVAL;
         }
         KfsDirIterator& theIt = *static_cast<KfsDirIterator*>(inDirIteratorPtr);
-        theIt.Next(outName, outStatPtr);
-        return 0;
+        return theIt.Next(outName, outStatPtr);
     }
     virtual int Chmod(
         const string& inPathName,
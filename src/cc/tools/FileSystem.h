@@ -137,6 +137,15 @@ public:
         const string& inDirName,
         bool          inFetchAttributesFlag,
         DirIterator*& outDirIteratorPtr) = 0;
+    // Same as Open() with attributes, but the entries are sorted by name,
+    // if the file system supports it.
+    virtual int OpenSorted(
+        const string& inDirName,
+        DirIterator*& outDirIteratorPtr)
+    {
+        const bool kFetchAttributesFlag = true;
+        return Open(inDirName, kFetchAttributesFlag, outDirIteratorPtr);
+    }
     virtual int Close(
         DirIterator* inDirIteratorPtr) = 0;
     virtual int Next(
@@ -30,10 +30,13 @@
 #include "common/MsgLogger.h"
 #include "common/Properties.h"
 #include "common/IntToString.h"
+#include "common/time.h"
 
 #include "kfsio/ZlibInflate.h"
 
 #include "qcdio/QCUtils.h"
+#include "qcdio/QCMutex.h"
+#include "qcdio/QCThread.h"
 #include "qcdio/qcstutils.h"
 
 #include "libclient/Path.h"
@@ -72,7 +75,9 @@ using std::deque;
 using std::map;
 using std::pair;
 using std::max;
+using std::min;
 using std::ostream;
+using std::ostringstream;
 using std::setw;
 using std::flush;
 using std::left;
@@ -98,6 +103,8 @@ public:
           mIoBufferPtr(new char[mIoBufferSize]),
           mDefaultCreateParams("S"), // RS 6+3 64K stripe
           mDelimeter(' '),
+          mCopyThreadCount(1),
+          mCopyProgressIntervalSec(0),
           mConfig()
         {}
     ~KfsTool()
@@ -216,6 +223,10 @@ public:
         }
         mDefaultCreateParams = mConfig.getValue(
             "fs.createParams", mDefaultCreateParams);
+        mCopyThreadCount = min(1024, max(1, mConfig.getValue(
+            "fs.copyThreads", mCopyThreadCount)));
+        mCopyProgressIntervalSec = mConfig.getValue(
+            "fs.copyProgressIntervalSec", mCopyProgressIntervalSec);
         const char* const theCmdPtr  = inArgsPtr[theArgIndex++] + 1;
         if (theCmdPtr[-1] != '-') {
             ShortHelp(cerr);
@@ -1272,9 +1283,7 @@ private:
             const string  kEmpty;
             if (mRecursionCount != 0 || S_ISDIR(mStat.st_mode)) {
                 FileSystem::DirIterator* theItPtr = 0;
-                const bool kFetchAttributesFlag = true;
-                if ((theErr = inFs.Open(
-                        inPath, kFetchAttributesFlag, theItPtr))) {
+                if ((theErr = inFs.OpenSorted(inPath, theItPtr))) {
                     mErrorStream << inFs.GetUri() << inPath <<
                         ": " << inFs.StrError(theErr) << "\n";
                     mStatus = theErr;
@@ -2167,6 +2176,7 @@ private:
         GetGlobLastEntry& operator=(
             const GetGlobLastEntry& inFunctor);
     };
+    class ParallelCopier;
     template<typename TGetGlobLastEntry>
     class CopyFunctor
     {
@@ -2184,7 +2194,8 @@ private:
               mMoveFlag(inMoveFlag),
               mOverwriteFlag(inOverwriteFlag),
               mCheckDestFlag(true),
-              mDefaultCreateParams(inDefaultCreateParams)
+              mDefaultCreateParams(inDefaultCreateParams),
+              mParallelCopierPtr(0)
             {}
         ~CopyFunctor()
             { delete [] mBufferPtr; }
@@ -2285,6 +2296,30 @@ private:
                     (mDstDirStat.st_mode & (0777 | S_ISVTX));
                 mCheckDestFlag = false;
             }
+            if (mParallelCopierPtr && ! mMoveFlag &&
+                    S_ISDIR(theStat.st_mode)) {
+                theStatus = mParallelCopierPtr->Copy(
+                    inFs,
+                    theDstFs,
+                    inErrorReporter,
+                    theDstErrorReporter,
+                    inFs == theDstFs ? &mDstDirStat : 0,
+                    mOverwriteFlag,
+                    mDefaultCreateParams,
+                    inPath,
+                    mDstName,
+                    theStat
+                );
+                if (theStatus == 0 && theSetModeFlag &&
+                        (theStatus = theDstFs.Chmod(mDstName,
+                            theStat.st_mode & (0777 | S_ISVTX), false, 0))
+                        != 0) {
+                    theStatus = theDstErrorReporter(mDstName, theStatus);
+                }
+                const int theDstStatus =
+                    inErrorReporter.CopyStatus(theDstErrorReporter);
+                return (theStatus == 0 ? theDstStatus : theStatus);
+            }
             if (! mBufferPtr) {
                 mBufferPtr = new char[kBufferSize];
             }
@@ -2313,6 +2348,9 @@ private:
         void SetDest(
             TGetGlobLastEntry& inDest)
             { mDestPtr = &inDest; }
+        void SetParallelCopier(
+            ParallelCopier* inCopierPtr)
+            { mParallelCopierPtr = inCopierPtr; }
     private:
         TGetGlobLastEntry*  mDestPtr;
         string              mDstName;
@@ -2323,6 +2361,7 @@ private:
         const bool          mOverwriteFlag;
         bool                mCheckDestFlag;
         const string        mDefaultCreateParams;
+        ParallelCopier*     mParallelCopierPtr;
     private:
         CopyFunctor(
             const CopyFunctor& inFunctor);
@@ -2339,6 +2378,11 @@ private:
         FunctorT<CpFunctor, CopyGetlastEntry, false, false>
             theFunc(theCopyFunc, cerr);
         theCopyFunc.SetDest(theFunc.GetInit());
+        ParallelCopier theParallelCopier(
+            mCopyThreadCount, mCopyProgressIntervalSec, cerr);
+        if (1 < mCopyThreadCount) {
+            theCopyFunc.SetParallelCopier(&theParallelCopier);
+        }
         const bool kNormalizePathFlag = false;
         return Apply(inArgsPtr, inArgCount, theFunc, kNormalizePathFlag);
     }
@@ -2444,6 +2488,11 @@ private:
         FunctorT<CpFunctor, CopyGetlastEntry, false, false>
             theFunc(theCopyFunc, cerr);
         theCopyFunc.SetDest(theFunc.GetInit());
+        ParallelCopier theParallelCopier(
+            mCopyThreadCount, mCopyProgressIntervalSec, cerr);
+        if (1 < mCopyThreadCount) {
+            theCopyFunc.SetParallelCopier(&theParallelCopier);
+        }
         return Apply(theGlob, theGlob.front().first != theFsPtr,
             theErrReporter.GetStatus(), theFunc);
     }
@@ -2507,9 +2556,32 @@ private:
         FunctorT<CpFunctor, CopyGetlastEntry, false, false>
             theFunc(theCopyFunc, cerr);
         theCopyFunc.SetDest(theFunc.GetInit());
+        ParallelCopier theParallelCopier(
+            mCopyThreadCount, mCopyProgressIntervalSec, cerr);
+        if (1 < mCopyThreadCount) {
+            theCopyFunc.SetParallelCopier(&theParallelCopier);
+        }
         return Apply(theGlob, theGlob.front().first != theFsPtr, theErr,
             theFunc);
     }
+    class CopyDispatcher
+    {
+    public:
+        // Queue directory or file copy, return false if copy is cancelled.
+        virtual bool Dispatch(
+            const string&              inSrcPath,
+            const string&              inDstPath,
+            const FileSystem::StatBuf& inSrcStat) = 0;
+        // Set directory mode after all copies complete.
+        virtual void SetDirMode(
+            const string& inDstPath,
+            kfsMode_t     inMode) = 0;
+    protected:
+        CopyDispatcher()
+            {}
+        virtual ~CopyDispatcher()
+            {}
+    };
     class Copier
     {
     public:
@@ -2538,7 +2610,9 @@ private:
               mSkipDirStatPtr(inSkipDirStatPtr),
               mRemoveSrcFlag(inRemoveSrcFlag),
               mOverwriteFlag(inOverwriteFlag),
-              mDefaultCreateParams(inDefaultCreateParams)
+              mDefaultCreateParams(inDefaultCreateParams),
+              mDispatcherPtr(0),
+              mCopiedByteCount(0)
             {}
         ~Copier()
         {
@@ -2628,6 +2702,18 @@ private:
                         }
                         break;
                     }
+                    if (mDispatcherPtr) {
+                        if (theCreatedFlag &&
+                                (theStat.st_mode & 0600) != 0600) {
+                            mDispatcherPtr->SetDirMode(
+                                mDstName, theStat.st_mode & (0777 | S_ISVTX));
+                        }
+                        if (! mDispatcherPtr->Dispatch(
+                                mSrcName, mDstName, theStat)) {
+                            break;
+                        }
+                        continue;
+                    }
                     if ((theStatus = CopyDir(
                             mSrcName, mDstName, theStat)) != 0) {
                         if (mDstErrorReporter(mDstName, theStatus) == 0) {
@@ -2647,6 +2733,11 @@ private:
                             break;
                         }
                     }
+                } else if (mDispatcherPtr) {
+                    if (! mDispatcherPtr->Dispatch(
+                            mSrcName, mDstName, theStat)) {
+                        break;
+                    }
                 } else {
                     if ((theStatus = CopyFile(
                             mSrcName, mDstName, theStat)) != 0) {
@@ -2753,6 +2844,7 @@ private:
                     break;
                 }
                 theTotal += theNRd;
+                mCopiedByteCount += theNRd;
                 if ((inSrcStat.st_mode & S_IFREG) != 0 &&
                         theNRd < (ssize_t)mBufferSize &&
                         theTotal >= inSrcStat.st_size) {
@@ -2781,6 +2873,13 @@ private:
             }
             return theStatus;
         }
+        // With dispatcher set CopyDir() creates sub directories, and queues
+        // directory and file copies instead of recursively copying these.
+        void SetDispatcher(
+            CopyDispatcher* inDispatcherPtr)
+            { mDispatcherPtr = inDispatcherPtr; }
+        int64_t GetCopiedByteCount() const
+            { return mCopiedByteCount; }
     private:
         // 5 comma separated 64 bit integers.
         enum { kTmpBufSize = (64 * 3 / 10 + 3) * 5 + 1 };
@@ -2800,6 +2899,8 @@ private:
         const bool                       mRemoveSrcFlag;
         const bool                       mOverwriteFlag;
         const string                     mDefaultCreateParams;
+        CopyDispatcher*                  mDispatcherPtr;
+        int64_t                          mCopiedByteCount;
         char                             mTmpBuf[kTmpBufSize];
     private:
         Copier(
@@ -2807,6 +2908,294 @@ private:
         Copier& operator=(
             const Copier& inCopier);
     };
+    // Copies directory tree with a pool of threads. The directories are
+    // processed one level at a time: a thread that lists a directory creates
+    // its sub directories, and queues the sub directories and files into the
+    // shared queue, therefore the tree walk and the file copies are
+    // distributed between all threads. Each thread has its own copy buffer,
+    // and copies one file at a time.
+    class ParallelCopier : public CopyDispatcher
+    {
+    public:
+        ParallelCopier(
+            int      inThreadCount,
+            int      inProgressIntervalSec,
+            ostream& inProgressStream)
+            : CopyDispatcher(),
+              mThreadCount(max(1, inThreadCount)),
+              mProgressIntervalSec(inProgressIntervalSec),
+              mProgressStream(inProgressStream),
+              mMutex(),
+              mCond(),
+              mDoneCond(),
+              mQueue(),
+              mDirModes(),
+              mPendingCount(0),
+              mStopFlag(false),
+              mStatus(0),
+              mSrcFsPtr(0),
+              mDstFsPtr(0),
+              mErrorStreamPtr(0),
+              mStopOnErrorFlag(false),
+              mSkipDirStatPtr(0),
+              mOverwriteFlag(false),
+              mDefaultCreateParamsPtr(0),
+              mFileCount(0),
+              mDirCount(0),
+              mByteCount(0)
+            {}
+        int Copy(
+            FileSystem&                inSrcFs,
+            FileSystem&                inDstFs,
+            ErrorReporter&             inSrcErrorReporter,
+            ErrorReporter&             inDstErrorReporter,
+            const FileSystem::StatBuf* inSkipDirStatPtr,
+            bool                       inOverwriteFlag,
+            const string&              inDefaultCreateParams,
+            const string&              inSrcPath,
+            const string&              inDstPath,
+            const FileSystem::StatBuf& inSrcStat)
+        {
+            mSrcFsPtr               = &inSrcFs;
+            mDstFsPtr               = &inDstFs;
+            mErrorStreamPtr         = &inSrcErrorReporter.GetErrorStream();
+            mStopOnErrorFlag        = inSrcErrorReporter.GetStopOnErrorFlag();
+            mSkipDirStatPtr         = inSkipDirStatPtr;
+            mOverwriteFlag          = inOverwriteFlag;
+            mDefaultCreateParamsPtr = &inDefaultCreateParams;
+            mStopFlag               = false;
+            mStatus                 = 0;
+            mFileCount              = 0;
+            mDirCount               = 0;
+            mByteCount              = 0;
+            mDirModes.clear();
+            Dispatch(inSrcPath, inDstPath, inSrcStat);
+            Worker* const theWorkersPtr = new Worker[mThreadCount];
+            for (int i = 0; i < mThreadCount; i++) {
+                const int kStackSize = 256 << 10;
+                theWorkersPtr[i].Start(*this, kStackSize);
+            }
+            const int64_t theStartTime = microseconds();
+            QCStMutexLocker theLock(mMutex);
+            while (0 < mPendingCount) {
+                if (mProgressIntervalSec <= 0) {
+                    mDoneCond.Wait(mMutex);
+                } else if (! mDoneCond.Wait(mMutex,
+                        QCMutex::Time(mProgressIntervalSec) * 1000 * 1000 *
+                        1000)) {
+                    ReportProgress(theStartTime);
+                }
+            }
+            theLock.Unlock();
+            delete [] theWorkersPtr;
+            if (0 < mProgressIntervalSec) {
+                ReportProgress(theStartTime);
+            }
+            // Set modes in the reverse order: sub directories first.
+            int theStatus = mStatus;
+            while (! mDirModes.empty()) {
+                const DirMode& theMode = mDirModes.back();
+                int theErr;
+                if ((theErr = inDstFs.Chmod(
+                        theMode.first, theMode.second, false, 0)) != 0) {
+                    inDstErrorReporter(theMode.first, theErr);
+                    if (theStatus == 0) {
+                        theStatus = theErr;
+                    }
+                }
+                mDirModes.pop_back();
+            }
+            return theStatus;
+        }
+        virtual bool Dispatch(
+            const string&              inSrcPath,
+            const string&              inDstPath,
+            const FileSystem::StatBuf& inSrcStat)
+        {
+            QCStMutexLocker theLock(mMutex);
+            if (mStopFlag) {
+                return false;
+            }
+            mQueue.push_back(Task());
+            Task& theTask = mQueue.back();
+            theTask.mSrcPath = inSrcPath;
+            theTask.mDstPath = inDstPath;
+            theTask.mStat    = inSrcStat;
+            mPendingCount++;
+            mCond.Notify();
+            return true;
+        }
+        virtual void SetDirMode(
+            const string& inDstPath,
+            kfsMode_t     inMode)
+        {
+            QCStMutexLocker theLock(mMutex);
+            mDirModes.push_back(make_pair(inDstPath, inMode));
+        }
+    private:
+        struct Task
+        {
+            Task()
+                : mSrcPath(),
+                  mDstPath(),
+                  mStat()
+                {}
+            string              mSrcPath;
+            string              mDstPath;
+            FileSystem::StatBuf mStat;
+        };
+        class Worker : public QCRunnable
+        {
+        public:
+            Worker()
+                : QCRunnable(),
+                  mOuterPtr(0),
+                  mThread()
+                {}
+            virtual ~Worker()
+                { mThread.Join(); }
+            void Start(
+                ParallelCopier& inOuter,
+                int             inStackSize)
+            {
+                mOuterPtr = &inOuter;
+                mThread.Start(this, inStackSize, "Copier");
+            }
+            virtual void Run()
+                { mOuterPtr->Run(); }
+        private:
+            ParallelCopier* mOuterPtr;
+            QCThread        mThread;
+        private:
+            Worker(
+                const Worker& inWorker);
+            Worker& operator=(
+                const Worker& inWorker);
+        };
+        friend class Worker;
+        typedef deque<Task>                  Queue;
+        typedef pair<string, kfsMode_t>      DirMode;
+        typedef vector<DirMode>              DirModes;
+
+        const int                  mThreadCount;
+        const int                  mProgressIntervalSec;
+        ostream&                   mProgressStream;
+        QCMutex                    mMutex;
+        QCCondVar                  mCond;
+        QCCondVar                  mDoneCond;
+        Queue                      mQueue;
+        DirModes                   mDirModes;
+        int64_t                    mPendingCount;
+        bool                       mStopFlag;
+        int                        mStatus;
+        FileSystem*                mSrcFsPtr;
+        FileSystem*                mDstFsPtr;
+        ostream*                   mErrorStreamPtr;
+        bool                       mStopOnErrorFlag;
+        const FileSystem::StatBuf* mSkipDirStatPtr;
+        bool                       mOverwriteFlag;
+        const string*              mDefaultCreateParamsPtr;
+        int64_t                    mFileCount;
+        int64_t                    mDirCount;
+        int64_t                    mByteCount;
+
+        void Run()
+        {
+            // Report errors into a thread local stream, and copy these into
+            // error stream with the mutex held to keep the messages intact.
+            ostringstream theErrorStream;
+            ErrorReporter theSrcErrorReporter(
+                *mSrcFsPtr, theErrorStream, mStopOnErrorFlag);
+            ErrorReporter theDstErrorReporter(
+                *mDstFsPtr, theErrorStream, mStopOnErrorFlag);
+            const bool kRemoveSrcFlag = false;
+            Copier theCopier(
+                *mSrcFsPtr,
+                *mDstFsPtr,
+                theSrcErrorReporter,
+                theDstErrorReporter,
+                0, // Own buffer.
+                0,
+                mSkipDirStatPtr,
+                kRemoveSrcFlag,
+                mOverwriteFlag,
+                *mDefaultCreateParamsPtr
+            );
+            theCopier.SetDispatcher(this);
+            QCStMutexLocker theLock(mMutex);
+            for (; ;) {
+                while (mQueue.empty() && 0 < mPendingCount) {
+                    mCond.Wait(mMutex);
+                }
+                if (mQueue.empty()) {
+                    break;
+                }
+                Task theTask;
+                theTask.mSrcPath.swap(mQueue.front().mSrcPath);
+                theTask.mDstPath.swap(mQueue.front().mDstPath);
+                theTask.mStat = mQueue.front().mStat;
+                mQueue.pop_front();
+                const int64_t theByteCount = theCopier.GetCopiedByteCount();
+                const bool    theDirFlag   = S_ISDIR(theTask.mStat.st_mode);
+                int           theStatus    = 0;
+                if (! mStopFlag) {
+                    QCStMutexUnlocker theUnlock(mMutex);
+                    theStatus = theCopier.Copy(
+                        theTask.mSrcPath, theTask.mDstPath, theTask.mStat);
+                }
+                if (theStatus == 0) {
+                    theStatus = theSrcErrorReporter.GetStatus();
+                }
+                if (theStatus == 0) {
+                    theStatus = theDstErrorReporter.GetStatus();
+                }
+                if (theStatus != 0) {
+                    if (mStatus == 0) {
+                        mStatus = theStatus;
+                    }
+                    if (mStopOnErrorFlag) {
+                        mStopFlag = true;
+                    }
+                }
+                if (theDirFlag) {
+                    mDirCount++;
+                } else {
+                    mFileCount++;
+                }
+                mByteCount += theCopier.GetCopiedByteCount() - theByteCount;
+                if (0 < theErrorStream.tellp()) {
+                    *mErrorStreamPtr << theErrorStream.str();
+                    theErrorStream.str(string());
+                }
+                if (--mPendingCount <= 0) {
+                    mCond.NotifyAll();
+                    mDoneCond.Notify();
+                }
+            }
+        }
+        void ReportProgress(
+            int64_t inStartTime)
+        {
+            const int64_t theElapsed = max(int64_t(1), microseconds() -
+                inStartTime);
+            mProgressStream <<
+                "elapsed: "  << (theElapsed + 500000) / 1000000 << " sec."
+                " dirs: "    << mDirCount <<
+                " files: "   << mFileCount <<
+                " bytes: "   << mByteCount <<
+                " rate: "    << (mByteCount * 1000000 / theElapsed >> 20) <<
+                    " MB/sec"
+                " files/sec: " << mFileCount * 1000000 / theElapsed <<
+                " queued: "  << mQueue.size() <<
+            "\n";
+            mProgressStream.flush();
+        }
+    private:
+        ParallelCopier(
+            const ParallelCopier& inCopier);
+        ParallelCopier& operator=(
+            const ParallelCopier& inCopier);
+    };
     static string& SetDirPath(
         const string& inPath,
         string&       ioPathName,
@@ -3014,11 +3403,9 @@ private:
                 return theStatus;
             }
             if (! IsSummary() && S_ISDIR(theStat.st_mode)) {
-                FileSystem::DirIterator* theItPtr             = 0;
-                const bool               kFetchAttributesFlag = true;
+                FileSystem::DirIterator* theItPtr = 0;
                 int                      theErr;
-                if ((theErr = inFs.Open(
-                        inPath, kFetchAttributesFlag, theItPtr)) != 0) {
+                if ((theErr = inFs.OpenSorted(inPath, theItPtr)) != 0) {
                     inErrorReporter(inPath, theErr);
                 } else {
                     string theName;
@@ -4526,6 +4913,8 @@ private:
     char* const  mIoBufferPtr;
     string       mDefaultCreateParams;
     char         mDelimeter;
+    int          mCopyThreadCount;
+    int          mCopyProgressIntervalSec;
     Properties   mConfig;
 private:
     KfsTool(const KfsTool& inTool);
@@ -4592,6 +4981,13 @@ const char* const KfsTool::sHelpStrings[] =
     "fs.columnSeparator\n\t\t\t"
         "set -ls[rst]* and -count column delimiter (single character).\n\t\t\t"
         "C escape sequences can be used to specify character code.\n\t\t"
+    "fs.copyThreads           = 1\n\t\t\t"
+        "number of threads used to copy directories with -cp, -put,\n\t\t\t"
+        "and -get. The threads walk the directory tree and copy files\n\t\t\t"
+        "in parallel.\n\t\t"
+    "fs.copyProgressIntervalSec = 0\n\t\t\t"
+        "report parallel directory copy progress and throughput with\n\t\t\t"
+        "the specified interval, 0 - no report.\n\t\t"
     "client.* QFS client parameters.\n\t\t\t"
         "Client parameter's decription, including client's\n\t\t\t"
         "authentication parameters [client.auth.] description\n\t\t\t"
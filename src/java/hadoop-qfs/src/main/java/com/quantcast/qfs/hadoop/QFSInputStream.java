@@ -90,6 +90,31 @@ class QFSInputStream extends FSInputStream {
     return res;
   }
 
+  // Positioned reads do not change the stream position, and are mapped
+  // directly onto the channel positional read.
+  public int read(long position, byte[] buffer, int offset, int length)
+    throws IOException {
+    final int res = kfsChannel.read(position,
+      ByteBuffer.wrap(buffer, offset, length));
+    if (0 < res && statistics != null) {
+      statistics.incrementBytesRead(res);
+    }
+    return res;
+  }
+
+  public void readFully(long position, byte[] buffer, int offset, int length)
+    throws IOException {
+    final int res = kfsChannel.read(position,
+      ByteBuffer.wrap(buffer, offset, length));
+    if (res < length) {
+      throw new EOFException("premature end of file: position: " +
+        position + " length: " + length + " read: " + res);
+    }
+    if (statistics != null) {
+      statistics.incrementBytesRead(res);
+    }
+  }
+
   public synchronized void close() throws IOException {
     kfsChannel.close();
   }
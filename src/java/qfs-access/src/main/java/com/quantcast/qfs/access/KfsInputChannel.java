@@ -45,6 +45,11 @@ final public class KfsInputChannel implements ReadableByteChannel, Positionable
 
     private final static native
     int read(long cPtr, int fd, ByteBuffer buf, int begin, int end);
+    private final static native
+    int pread(long cPtr, int fd, long pos, ByteBuffer buf, int begin, int end);
+    private final static native
+    long preadv(long cPtr, int fd, long[] pos, ByteBuffer[] bufs,
+        int[] begins, int[] ends, int[] sizes);
 
     KfsInputChannel(KfsAccess ka, int fd) 
     {
@@ -133,6 +138,95 @@ final public class KfsInputChannel implements ReadableByteChannel, Positionable
         buf.position(pos + sz);
     }
 
+    // Positional read, similar to FileChannel.read(ByteBuffer, long): the
+    // current position is not changed. Direct buffers are filled with a
+    // single native call; heap buffers are copied through a pooled direct
+    // buffer. Returns -1 if position is at or past the end of file.
+    public synchronized int read(long position, ByteBuffer dst)
+        throws IOException
+    {
+        if (kfsFd < 0) {
+            throw new IOException("File closed");
+        }
+        if (position < 0) {
+            throw new IllegalArgumentException("read position: " + position);
+        }
+        final int r0 = dst.remaining();
+        if (r0 <= 0) {
+            return 0;
+        }
+        if (dst.isDirect()) {
+            final int pos = dst.position();
+            final int sz  = pread(kfsAccess.getCPtr(), kfsFd, position,
+                dst, pos, dst.limit());
+            kfsAccess.kfs_retToIOException(sz);
+            dst.position(pos + sz);
+            return sz <= 0 ? -1 : sz;
+        }
+        final BufferPool pool = BufferPool.getInstance();
+        final ByteBuffer buf  = pool.getBuffer();
+        try {
+            long off = position;
+            while (dst.hasRemaining()) {
+                buf.clear();
+                final int end = Math.min(buf.capacity(), dst.remaining());
+                final int sz  = pread(kfsAccess.getCPtr(), kfsFd, off,
+                    buf, 0, end);
+                kfsAccess.kfs_retToIOException(sz);
+                if (sz <= 0) {
+                    break;
+                }
+                buf.limit(sz);
+                dst.put(buf);
+                off += sz;
+                if (sz < end) {
+                    break;
+                }
+            }
+        } finally {
+            pool.releaseBuffer(buf);
+        }
+        final int r1 = dst.remaining();
+        return r1 < r0 ? r0 - r1 : -1;
+    }
+
+    // Vectored positional read: fills each direct buffer dsts[i] from its
+    // position to its limit starting at file position positions[i], with a
+    // single native call. Buffer positions are advanced by the number of
+    // bytes read. Reading stops at the first short read, i.e. at the end of
+    // file. Returns total number of bytes read.
+    public synchronized long read(long[] positions, ByteBuffer[] dsts)
+        throws IOException
+    {
+        if (kfsFd < 0) {
+            throw new IOException("File closed");
+        }
+        if (positions.length != dsts.length) {
+            throw new IllegalArgumentException(
+                "positions and buffers length mismatch");
+        }
+        final int   cnt    = dsts.length;
+        final int[] begins = new int[cnt];
+        final int[] ends   = new int[cnt];
+        final int[] sizes  = new int[cnt];
+        for (int i = 0; i < cnt; i++) {
+            if (!dsts[i].isDirect()) {
+                throw new IllegalArgumentException("need direct buffer");
+            }
+            begins[i] = dsts[i].position();
+            ends[i]   = dsts[i].limit();
+        }
+        final long ret = preadv(kfsAccess.getCPtr(), kfsFd, positions, dsts,
+            begins, ends, sizes);
+        if (ret < 0) {
+            kfsAccess.kfs_retToIOException((int)ret);
+        }
+        for (int i = 0; i < cnt; i++) {
+            dsts[i].position(begins[i] + sizes[i]);
+        }
+        return ret;
+    }
+
     // is modeled after the seek of Java's RandomAccessFile; offset is
     // the offset from the beginning of the file.
     public synchronized long seek(long offset) throws IOException
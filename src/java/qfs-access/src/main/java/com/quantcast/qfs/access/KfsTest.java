@@ -317,6 +317,8 @@ public class KfsTest
                 System.out.println("After seek, we are at: " + sz);
             }
 
+            testPositionalRead(inputChannel, dataBuf);
+
             inputChannel.close();
 
             // remove the file
@@ -368,6 +370,56 @@ public class KfsTest
         }
     }
 
+    private static void testPositionalRead(KfsInputChannel inputChannel,
+            char[] dataBuf) throws IOException
+    {
+        final long pos = inputChannel.tell();
+        final byte[] buf = new byte[64];
+        int res = inputChannel.read(16, ByteBuffer.wrap(buf));
+        if (res != buf.length) {
+            System.out.println("Positional read returned: " + res);
+            System.exit(1);
+        }
+        for (int i = 0; i < buf.length; i++) {
+            if (dataBuf[16 + i] != (char)buf[i]) {
+                System.out.println("Positional read mismatch at: " + i);
+                System.exit(1);
+            }
+        }
+        final ByteBuffer[] bufs = new ByteBuffer[] {
+            ByteBuffer.allocateDirect(32),
+            ByteBuffer.allocateDirect(32)
+        };
+        final long[] offsets = new long[] { 100, 8 };
+        final int  iterations = 1000;
+        final long start      = System.nanoTime();
+        long       total      = 0;
+        for (int k = 0; k < iterations; k++) {
+            bufs[0].clear();
+            bufs[1].clear();
+            total += inputChannel.read(offsets, bufs);
+        }
+        final long elapsed = Math.max(1, System.nanoTime() - start);
+        for (int k = 0; k < bufs.length; k++) {
+            bufs[k].flip();
+            for (int i = 0; bufs[k].hasRemaining(); i++) {
+                if (dataBuf[(int)offsets[k] + i] != (char)bufs[k].get()) {
+                    System.out.println("Vectored read mismatch: " + k +
+                        " at: " + i);
+                    System.exit(1);
+                }
+            }
+        }
+        if (inputChannel.tell() != pos) {
+            System.out.println("Positional read changed position: " +
+                inputChannel.tell() + " expected: " + pos);
+            System.exit(1);
+        }
+        System.out.println("Vectored read: " +
+            (iterations * 1000000000L / elapsed) + " calls/sec " +
+            (total * 1000000000L / elapsed) + " bytes/sec");
+    }
+
     private static Random randGen = new Random(100);
 
     private static void generateData(char buf[], int numBytes)